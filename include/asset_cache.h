@@ -4,10 +4,20 @@
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
+#include <list>
 #include <cstdint>
 #include <functional>
+#include <initializer_list>
+#include <deque>
+#include <mutex>
+#include <future>
+#include "asset_handle.h"
+#include "texture_atlas.h"
+#include "load_timing.h"
 
 struct SDL_Texture;
+struct SDL_Surface;
 struct SDL_Renderer;
 struct Mix_Chunk;
 struct _Mix_Music;
@@ -18,6 +28,11 @@ namespace opengg {
 // Forward declarations
 class NEResourceExtractor;
 class GrpArchive;
+class ResourceCatalog;
+class CachePack;
+class DirectoryIndex;
+class JobPool;
+class SpriteIndex;
 struct Sprite;
 struct Resource;
 
@@ -34,12 +49,14 @@ enum class AssetType {
 struct AssetMeta {
     std::string id;
     AssetType type;
-    std::string sourcePath;
+    std::string sourcePath;     // Game file the asset was extracted from
     uint32_t sourceOffset;
-    uint32_t crc32;
+    uint32_t crc32;             // CRC of the cached data
     uint64_t timestamp;
     uint32_t width;
     uint32_t height;
+    uint64_t sourceSize;        // Source file size and timestamp when cached;
+    int64_t sourceModified;     // the asset is only re-checked once these change
 };
 
 // Cached texture with reference counting
@@ -52,6 +69,25 @@ struct CachedTexture {
     CachedTexture() : texture(nullptr), width(0), height(0), refCount(0) {}
 };
 
+// Asynchronous texture load (see AssetCache::requestTexture)
+// Filled in on the main thread by AssetCache::pumpUploads()
+struct TextureRequest {
+    enum class State {
+        Pending,
+        Ready,
+        Failed
+    };
+
+    std::string assetId;
+    State state = State::Pending;
+    SDL_Texture* texture = nullptr;
+    int width = 0;
+    int height = 0;
+    std::string error;
+
+    bool isDone() const { return state != State::Pending; }
+};
+
 // Asset Cache System
 // Extracts assets from original game files and caches converted versions
 class AssetCache {
@@ -65,18 +101,31 @@ public:
     // Set SDL renderer for texture creation
     void setRenderer(SDL_Renderer* renderer);
 
-    // Check if cache is valid (matches original files)
+    // Check cached data against the original files, dropping stale entries
+    // Only assets whose source file size or timestamp changed are
+    // re-extracted and compared. Returns false if anything was dropped.
     bool validateCache();
 
     // Clear all cached data
     void clearCache();
 
+    // Rescan the game directories and rewrite the resource catalog
+    bool rebuildCatalog();
+
+    // Rescan the game and extracted asset directories (after files were
+    // added or removed while running)
+    void refreshDirectoryIndex();
+
     // Get texture by asset ID (e.g., "gizmo256:bitmap:100")
     SDL_Texture* getTexture(const std::string& assetId);
 
     // Get sprite data by ID
     std::shared_ptr<Sprite> getSprite(const std::string& assetId);
 
+    // Frame index of an NE sprite file (e.g. "GIZMO256"), loaded from the
+    // cache dir or built and saved there on first use. Owned by the cache.
+    const SpriteIndex* getSpriteIndex(const std::string& source);
+
     // Get sound effect
     Mix_Chunk* getSound(const std::string& assetId);
 
@@ -86,11 +135,84 @@ public:
     // Get raw data
     std::vector<uint8_t> getData(const std::string& assetId);
 
-    // Release a texture (decrement ref count)
+    // === Asset handles ===
+    // Intern an asset ID (the same ID always gets the same handle). Nothing
+    // is loaded until the handle is first used.
+    AssetHandle resolve(const std::string& assetId);
+
+    // Asset ID a handle was resolved from (empty if invalid)
+    const std::string& getAssetId(AssetHandle handle) const;
+
+    // Same as the lookups by ID; loaded assets are found without hashing
+    SDL_Texture* getTexture(AssetHandle handle);
+    Mix_Chunk* getSound(AssetHandle handle);
+    Mix_Music* getMusic(AssetHandle handle);
+    void releaseTexture(AssetHandle handle);
+
+    // Release a texture (decrement ref count); unreferenced textures stay
+    // cached until their class goes over budget
     void releaseTexture(const std::string& assetId);
 
-    // Preload assets matching a pattern
-    void preload(const std::string& pattern);
+    // Free an asset now unless it is still in use (referenced texture,
+    // sprite held elsewhere, sound or music playing)
+    bool evict(AssetType type, const std::string& assetId);
+
+    // Memory budget per asset class in bytes (0 = unlimited). When a class
+    // goes over budget its least recently used assets that are not in use
+    // are freed; they reload on the next request.
+    struct MemoryBudget {
+        size_t textures = 256 * 1024 * 1024;
+        size_t sprites = 64 * 1024 * 1024;
+        size_t sounds = 64 * 1024 * 1024;
+        size_t music = 16 * 1024 * 1024;
+    };
+    void setMemoryBudget(const MemoryBudget& budget);
+    const MemoryBudget& getMemoryBudget() const { return budget_; }
+
+    // Preload cached assets whose ID matches a glob pattern ('*' and '?',
+    // e.g. "gizmo256:bitmap:1*"). Matches load as one batch in source file
+    // and offset order: everything is read and decoded on the worker pool,
+    // then textures are uploaded before returning and left cached without
+    // a reference. Call from the main thread. Returns the number of assets
+    // matched.
+    size_t preload(const std::string& pattern);
+
+    // === Asynchronous loading ===
+    // File reads and BMP decoding run on a worker pool; SDL textures are
+    // created on the main thread by pumpUploads(). A completed request holds
+    // one texture reference, the same as a getTexture() call.
+
+    // Queue a texture load by asset ID (shares the request already in flight)
+    std::shared_ptr<TextureRequest> requestTexture(const std::string& assetId);
+
+    // Queue a load of extracted/<gameId>/sprites/<spriteName>.bmp
+    std::shared_ptr<TextureRequest> requestExtractedTexture(const std::string& gameId,
+                                                            const std::string& spriteName);
+
+    // Create textures for decoded requests until budgetMs has elapsed (at
+    // least one per call). Call once per frame from the main thread.
+    size_t pumpUploads(double budgetMs);
+
+    // Give up the reference a request holds or will hold: released now if
+    // the request is Ready, or not handed out if it is still in flight
+    void releaseRequest(const std::shared_ptr<TextureRequest>& request);
+
+    // Number of requests not yet completed by pumpUploads()
+    size_t getPendingRequests() const { return pendingTextures_.size(); }
+
+    // Block until every queued decode has finished (uploads still need pumpUploads)
+    void waitForDecodes();
+
+    // Worker thread count for async loads (0 = from hardware); applies
+    // before the first request
+    void setWorkerCount(size_t count) { workerCount_ = count; }
+
+    // A load that ranks among the slowest so far
+    struct SlowLoad {
+        std::string assetId;
+        AssetType type;
+        LoadTiming timing;
+    };
 
     // Get cache statistics
     struct Stats {
@@ -99,10 +221,22 @@ public:
         size_t soundsLoaded;
         size_t cacheHits;
         size_t cacheMisses;
-        size_t memoryUsed;
+        size_t memoryUsed;      // Bytes held by textures, sprites, sounds and music
+        size_t evictions;       // Assets freed to stay within budget
+        size_t reloads;         // Loads of assets that had been evicted
+        size_t sharedLoads;     // Loads served by an identical asset already in memory
+        size_t bytesShared;     // Memory saved by that sharing (already taken off memoryUsed)
+        size_t bytesFromDisk;   // Source bytes read from game and extracted files
+        size_t bytesFromCache;  // Source bytes read from the cache pack
+        LoadProfile loads[5];   // Latency of loads that missed, indexed by AssetType
+        std::vector<SlowLoad> slowestLoads;     // Slowest first
     };
     Stats getStats() const;
 
+    // getStats() as a JSON object (percentiles and times in ms), for
+    // dumping to a file when chasing load-time regressions
+    std::string getStatsJson() const;
+
     // Get last error
     std::string getLastError() const { return lastError_; }
 
@@ -135,12 +269,29 @@ public:
     SDL_Texture* loadExtractedTexture(const std::string& gameId, const std::string& spriteName,
                                        int* outWidth = nullptr, int* outHeight = nullptr);
 
+    // Release a texture from loadExtractedTexture()
+    void releaseExtractedTexture(const std::string& gameId, const std::string& spriteName);
+
     // Load a sound from extracted/<gameId>/audio/wav/<soundName>.wav
     Mix_Chunk* loadExtractedSound(const std::string& gameId, const std::string& soundName);
 
     // Load music from extracted/<gameId>/audio/midi/<midiName>.mid
     Mix_Music* loadExtractedMusic(const std::string& gameId, const std::string& midiName);
 
+    // Pack extracted sprites into shared atlas pages under atlasName (e.g.
+    // one atlas per game or per room; an existing atlas is added to).
+    // Sprites decode on the worker pool. Returns the number of sprites now
+    // in the atlas; missing ones are skipped.
+    size_t buildAtlas(const std::string& atlasName, const std::string& gameId,
+                      const std::vector<std::string>& spriteNames);
+
+    // Page texture and sub-rect of a sprite packed by buildAtlas()
+    bool getAtlasRegion(const std::string& gameId, const std::string& spriteName,
+                        AtlasRegion& out) const;
+
+    // Free an atlas and its pages
+    void releaseAtlas(const std::string& atlasName);
+
     // List files in an extracted game's asset directory
     // category: "sprites", "wav", "midi", "puzzles", "rooms", "video"
     std::vector<std::string> listExtractedAssets(const std::string& gameId, const std::string& category);
@@ -150,18 +301,140 @@ public:
     static bool parseAssetId(const std::string& assetId, std::string& source, std::string& type, int& id);
 
 private:
+    // Texture decoded on a worker, waiting for upload on the main thread
+    struct DecodedTexture {
+        std::shared_ptr<TextureRequest> request;
+        std::vector<uint32_t> pixels;       // ARGB8888 rows, top row first
+        int width = 0;
+        int height = 0;
+        SDL_Surface* surface = nullptr;     // Formats parseBitmap() rejects
+        std::vector<uint8_t> sourceData;    // Written to the disk cache after upload
+        bool loadOnMainThread = false;      // Source can't be read off the main thread
+        uint64_t contentKey = 0;            // See contentKey(); 0 if unknown
+        LoadTiming timing;                  // Worker stages; upload is added on the main thread
+        std::string error;
+    };
+
+    // Least recently used order and byte sizes for one asset class
+    struct LRUEntry {
+        std::list<std::string>::iterator position;
+        size_t bytes;
+    };
+    struct LRUList {
+        std::list<std::string> order;   // Most recently used first
+        std::unordered_map<std::string, LRUEntry> entries;
+        size_t bytesUsed = 0;
+    };
+
+    // Interned asset ID and direct pointers to its loaded assets (null
+    // while not loaded). Map nodes don't move, so the pointers stay good
+    // until the asset is freed, which clears them.
+    struct HandleSlot {
+        std::string assetId;
+        CachedTexture* texture = nullptr;
+        Mix_Chunk* sound = nullptr;
+        Mix_Music* music = nullptr;
+        LRUEntry* lru[4] = {};          // Indexed by AssetType
+    };
+
+    // Texture or chunk loaded once and shared by every asset ID whose
+    // source data is identical (same CRC and size)
+    struct SharedPayload {
+        void* payload = nullptr;        // SDL_Texture* or Mix_Chunk*
+        int width = 0;                  // Textures only
+        int height = 0;
+        size_t bytes = 0;
+        size_t users = 0;               // Asset IDs using it
+    };
+
+    // In-flight texture request and the references it will hand out
+    struct PendingTexture {
+        std::shared_ptr<TextureRequest> request;
+        int refCount = 0;
+    };
+
+    // Async loading internals
+    std::shared_ptr<TextureRequest> queueTextureRequest(const std::string& key,
+                                                        std::function<void(DecodedTexture&)> decode);
+    void decodeTexture(DecodedTexture& decoded) const;
+    void completeUpload(DecodedTexture& decoded);
+    void cancelRequests(const std::string& reason);
+
+    // Read a texture's source bytes from the disk cache or the catalog;
+    // touches no mutable state, so it is safe on worker threads
+    bool readTextureSource(const std::string& assetId, std::vector<uint8_t>& data,
+                           bool& fromDiskCache, LoadTiming* timing) const;
+
+    // Resolve extracted/<gameId>/sprites/<spriteName> to a file (empty if missing)
+    std::string findExtractedSprite(const std::string& basePath, const std::string& gameId,
+                                    const std::string& spriteName) const;
+
+    // Memory budget bookkeeping (Texture, Sprite, Sound and Music only)
+    size_t getBudget(AssetType type) const;
+    void trackAsset(AssetType type, const std::string& key, size_t bytes);
+    void touchAsset(AssetType type, const std::string& key);
+    void untrackAsset(AssetType type, const std::string& key);
+    void enforceBudget(AssetType type);
+    bool freeAsset(AssetType type, const std::string& key);
+
+    // Point a handle's slot at the loaded asset (or null), after the asset
+    // was loaded or freed
+    HandleSlot* findHandle(const std::string& assetId);
+    void bindHandle(HandleSlot& slot, AssetType type);
+    void updateHandle(AssetType type, const std::string& assetId);
+    void touchHandle(HandleSlot& slot, AssetType type);
+
+    // Content-hash sharing between asset IDs (Texture and Sound). Each
+    // asset ID is still cached and budgeted on its own; only the payload
+    // is shared, and it is freed with its last user.
+    SDL_Texture* useSharedTexture(const std::string& assetId, uint64_t contentKey, int refCount);
+    Mix_Chunk* useSharedSound(const std::string& assetId, uint64_t contentKey);
+    void addShared(AssetType type, const std::string& assetId, uint64_t contentKey,
+                   const SharedPayload& payload);
+    size_t getSharedUsers(AssetType type, const std::string& assetId) const;
+    bool releaseShared(AssetType type, const std::string& assetId);
+
     // Internal asset loading
     bool loadFromNE(const std::string& source, const std::string& type, int id,
-                    std::vector<uint8_t>& data);
+                    std::vector<uint8_t>& data, LoadTiming* timing = nullptr);
     bool loadFromGrp(const std::string& source, const std::string& name,
-                     std::vector<uint8_t>& data);
+                     std::vector<uint8_t>& data, LoadTiming* timing = nullptr);
 
-    // Cache file operations
+    // Texture from BMP file data, expanded straight into a locked ARGB8888
+    // texture; formats parseBitmap() rejects are decoded by SDL_LoadBMP
+    SDL_Texture* createTextureFromBMP(const uint8_t* data, size_t size, int& width, int& height,
+                                      LoadTiming* timing = nullptr);
+
+    // Add a finished load to the latency stats (main thread only)
+    void recordLoad(AssetType type, const std::string& assetId, const LoadTiming& timing);
+
+    // Locate a game file in the known game subdirectories (empty if missing)
+    std::string findGameFile(const std::string& filename) const;
+
+    // Find a file in the first of dirs (relative to the game root) that has it
+    std::string findInGameDirs(std::initializer_list<const char*> dirs,
+                               const std::string& filename) const;
+
+    // The resource catalog; a lookup that arrives before the background
+    // load has finished waits for it. Thread-safe.
+    const ResourceCatalog& catalog() const;
+
+    // Load the resource catalog from the cache dir, rebuilding it if stale
+    // (runs on the background thread)
+    void loadCatalog();
+
+    // Block until the background catalog load (if any) has finished
+    void waitForCatalog() const;
+
+    // Disk cache operations (backed by the cache pack)
+    bool openCachePack();
     bool loadCacheIndex();
     bool saveCacheIndex();
-    std::string getCacheFilePath(const std::string& assetId) const;
-    bool saveToCache(const std::string& assetId, const std::vector<uint8_t>& data);
-    std::vector<uint8_t> loadFromCache(const std::string& assetId);
+    std::string findSourceFile(const std::string& assetId, uint32_t& offset) const;
+    bool extractAsset(const std::string& assetId, std::vector<uint8_t>& data);
+    bool saveToCache(const std::string& assetId, const std::vector<uint8_t>& data, AssetType type);
+    std::vector<uint8_t> loadFromCache(const std::string& assetId,
+                                       LoadTiming* timing = nullptr) const;
 
     // CRC32 calculation
     uint32_t calculateCRC32(const std::vector<uint8_t>& data);
@@ -179,9 +452,45 @@ private:
     // Source file handles (lazy loaded)
     std::unordered_map<std::string, std::unique_ptr<NEResourceExtractor>> neFiles_;
     std::unordered_map<std::string, std::unique_ptr<GrpArchive>> grpFiles_;
+    std::unordered_map<std::string, std::unique_ptr<SpriteIndex>> spriteIndexes_;
+
+    // Atlases of extracted sprites by name (see buildAtlas)
+    std::unordered_map<std::string, std::unique_ptr<TextureAtlas>> atlases_;
+
+    // Prebuilt index of every resource under gamePath_, loaded or built on
+    // a background thread started by initialize() (see catalog())
+    std::unique_ptr<ResourceCatalog> catalog_;
+    std::shared_future<void> catalogReady_;
+
+    // Listings of game and extracted directories, for path lookups
+    std::unique_ptr<DirectoryIndex> dirIndex_;
 
-    // Cache index
+    // Extracted source data of previously loaded assets, in one pack file,
+    // and where each blob came from
+    std::unique_ptr<CachePack> pack_;
     std::unordered_map<std::string, AssetMeta> cacheIndex_;
+    bool cacheIndexDirty_ = false;
+
+    // Async loading: worker pool (created on first request), requests by
+    // asset ID, and decoded textures handed back by the workers
+    std::unique_ptr<JobPool> loadPool_;
+    size_t workerCount_ = 0;
+    std::unordered_map<std::string, PendingTexture> pendingTextures_;
+    std::mutex decodedMutex_;
+    std::deque<DecodedTexture> decoded_;
+
+    // Memory budgets and LRU order per asset class
+    MemoryBudget budget_;
+    LRUList lru_[4];    // Indexed by AssetType
+    std::unordered_set<std::string> evictedAssets_;
+
+    // Shared payloads by content key, and the key each asset ID uses
+    std::unordered_map<uint64_t, SharedPayload> shared_[4];     // Indexed by AssetType
+    std::unordered_map<std::string, uint64_t> contentKeys_[4];
+
+    // Interned asset IDs; handle.index indexes handles_ (slot 0 unused)
+    std::vector<HandleSlot> handles_;
+    std::unordered_map<std::string, uint32_t> handleIndex_;
 
     // Statistics
     mutable Stats stats_ = {};
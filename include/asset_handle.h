@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+namespace opengg {
+
+// Interned asset ID, from AssetCache::resolve()
+// Lookups by handle index a dense array instead of hashing the ID string,
+// so per-frame code should resolve its assets once and keep the handles.
+// A handle stays valid for the lifetime of the cache that issued it, even
+// while the asset itself is evicted or the cache is cleared.
+struct AssetHandle {
+    uint32_t index = 0;     // 0 = no asset
+
+    bool isValid() const { return index != 0; }
+    bool operator==(const AssetHandle& other) const { return index == other.index; }
+    bool operator!=(const AssetHandle& other) const { return index != other.index; }
+};
+
+} // namespace opengg
@@ -5,6 +5,7 @@
 #include <memory>
 #include <unordered_map>
 #include <cstdint>
+#include "asset_handle.h"
 
 struct Mix_Chunk;
 struct _Mix_Music;
@@ -53,13 +54,19 @@ public:
     void setMuted(bool muted);
     bool isMuted() const { return muted_; }
 
+    // Resolve a sound ID to a handle once (needs the asset cache set), then
+    // play it by handle without per-call string lookups
+    AssetHandle resolveSound(const std::string& id);
+
     // Sound effects
     int playSound(const std::string& id, float volume = 1.0f);
+    int playSound(AssetHandle sound, float volume = 1.0f);
     int playSound(Mix_Chunk* chunk, float volume = 1.0f);
     int playSoundLooped(const std::string& id, int loops = -1, float volume = 1.0f);
 
     // Positional audio (for 2D spatial sound)
     int playSoundAt(const std::string& id, int x, int y, float volume = 1.0f);
+    int playSoundAt(AssetHandle sound, int x, int y, float volume = 1.0f);
     void setListenerPosition(int x, int y);
 
     // Channel control
@@ -83,6 +90,13 @@ public:
     void fadeOutMusic(int fadeMs);
     void crossfadeMusic(const std::string& id, int fadeMs);
 
+    // Streamed audio in place of music (e.g. a video soundtrack). The
+    // callback runs on the audio thread and must fill the whole buffer with
+    // 16-bit samples in the device format (see getOutputFormat()).
+    bool hookStream(void (*callback)(void* userdata, uint8_t* stream, int bytes), void* userdata);
+    void unhookStream();
+    bool getOutputFormat(int& frequency, int& channels) const;
+
     // Queue system for sequential playback
     void queueSound(const std::string& id);
     void clearQueue();
@@ -99,6 +113,7 @@ public:
 private:
     Mix_Chunk* getChunk(const std::string& id);
     Mix_Music* getMusicHandle(const std::string& id);
+    int playChunkAt(Mix_Chunk* chunk, int x, int y, float volume);
     int calculatePan(int soundX, int soundY) const;
     uint8_t calculateDistance(int soundX, int soundY) const;
 
@@ -114,10 +129,6 @@ private:
     int listenerX_ = 320;  // Center of 640x480 screen
     int listenerY_ = 240;
 
-    // Sound/music caches
-    std::unordered_map<std::string, Mix_Chunk*> sounds_;
-    std::unordered_map<std::string, Mix_Music*> musicCache_;
-
     // Current music
     std::string currentMusicId_;
 
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+
+namespace opengg {
+
+class MappedFile;
+
+#pragma pack(push, 1)
+
+// Pack file header. Two copies live at the start of the file (slots A and
+// B); each commit writes the slot not currently in use, so a crash while
+// committing always leaves the previous header intact.
+struct CachePackHeader {
+    char     magic[4];          // "OGCP"
+    uint32_t version;
+    uint64_t sequence;          // Bumped on every commit; highest valid slot wins
+    uint64_t indexOffset;       // Sorted CachePackEntry table, then the string pool
+    uint32_t indexCount;
+    uint32_t stringPoolSize;
+    uint64_t dataEnd;           // End of committed data; later bytes are discarded
+    uint64_t liveBytes;         // Blob bytes referenced by the index
+    uint32_t indexCRC;          // CRC of the entry table and string pool
+    uint32_t headerCRC;         // CRC of all fields above
+    uint8_t  reserved[8];
+};
+
+// One cached blob, sorted by ID
+struct CachePackEntry {
+    uint64_t offset;            // Blob offset (aligned)
+    uint32_t size;
+    uint32_t idOffset;          // Asset ID in the string pool
+    uint32_t idLength;
+    uint32_t tag;               // Caller-defined (AssetCache stores the AssetType)
+    uint32_t crc32;             // CRC of the blob
+    uint32_t reserved;
+    uint64_t timestamp;         // Time the blob was written
+};
+
+#pragma pack(pop)
+
+// Summary of a cached blob
+struct CachePackInfo {
+    std::string id;
+    uint32_t tag;
+    uint32_t size;
+    uint32_t crc32;
+    uint64_t timestamp;
+    uint64_t offset;            // Blob offset in the pack (UINT64_MAX while pending)
+};
+
+// Append-only, memory-mapped store for cached asset blobs
+// Replaces one file per asset: the pack is mapped once on open, lookups are
+// a binary search over the mapped index, and reads copy straight out of the
+// mapping. New blobs are batched in memory and appended on commit together
+// with a fresh index, then the spare header slot is switched over. Space
+// held by replaced blobs and old indexes is reclaimed by compaction.
+class CachePack {
+public:
+    CachePack();
+    ~CachePack();
+
+    CachePack(const CachePack&) = delete;
+    CachePack& operator=(const CachePack&) = delete;
+
+    // Open (or create) a pack file
+    bool open(const std::string& path);
+
+    // Commit pending writes and close the pack
+    void close();
+
+    bool isOpen() const { return isOpen_; }
+
+    // Check for / read a blob. Thread-safe.
+    bool contains(const std::string& id) const;
+    bool read(const std::string& id, std::vector<uint8_t>& out) const;
+
+    // Queue a blob (replacing any older one with the same ID). Readable
+    // immediately; written to disk on the next commit, which happens
+    // automatically once enough data is pending.
+    bool write(const std::string& id, const uint8_t* data, size_t size, uint32_t tag);
+
+    // Drop a blob (takes effect on disk with the next commit)
+    void remove(const std::string& id);
+
+    // Append pending blobs and a new index, then switch headers
+    bool commit();
+
+    // Rewrite the pack with only live blobs
+    bool compact();
+
+    // Drop every blob and truncate the pack
+    bool clear();
+
+    // Cached blobs (committed and pending) whose ID starts with prefix; all
+    // of them for an empty prefix. The committed range is found by binary
+    // search, so a specific prefix costs only its matches.
+    std::vector<CachePackInfo> list(const std::string& prefix = {}) const;
+
+    size_t getEntryCount() const;
+    uint64_t getFileSize() const;
+    uint64_t getLiveBytes() const;
+
+    // Get last error
+    std::string getLastError() const;
+
+private:
+    struct PendingBlob {
+        std::vector<uint8_t> data;
+        uint32_t tag;
+        uint32_t crc32;
+        uint64_t timestamp;
+        bool removed = false;   // Tombstone for a committed blob
+    };
+
+    bool loadIndex();
+    bool createEmpty();
+    bool commitLocked();
+    bool compactLocked();
+    bool writePack(const std::string& path, bool rewrite);
+    const CachePackEntry* findEntry(const std::string& id) const;
+    std::string getEntryId(const CachePackEntry& entry) const;
+
+    std::string path_;
+    bool isOpen_ = false;
+
+    // Mapping and the committed index inside it
+    std::unique_ptr<MappedFile> mapping_;
+    CachePackHeader header_{};
+    int headerSlot_ = 0;
+    const CachePackEntry* entries_ = nullptr;
+    const char* strings_ = nullptr;
+
+    // Blobs written since the last commit
+    std::unordered_map<std::string, PendingBlob> pending_;
+    size_t pendingBytes_ = 0;
+
+    mutable std::mutex mutex_;
+    std::string lastError_;
+};
+
+} // namespace opengg
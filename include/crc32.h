@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace opengg {
+
+// CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320), same as zip/PNG
+// Pass the previous result as `crc` to continue a running checksum
+uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0);
+
+} // namespace opengg
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace opengg {
+
+// Shared decompression kernels for sprite and archive data
+// Every decoder writes into a caller-sized buffer, never past dstSize, and
+// returns the number of bytes produced. Runs become fills and literal
+// spans become bulk copies; bounds are checked once per span.
+
+// GRP entry RLE (flag GRP_COMPRESSION_RLE)
+// Control byte with bit 7 set: run of (c & 0x7F) + 1 copies of the next byte
+// Otherwise: (c + 1) literal bytes follow
+size_t decodeRLEPackBits(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+// DAT sprite RLE (see SpriteDecoder)
+// FF <byte> <count>: repeat byte count times (a count of 0 is treated as 1)
+// Any other byte: literal pixel
+size_t decodeRLEEscapeFF(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+// GRP sprite pixel RLE (see GrpArchive::extractSprite)
+// 00 <n>: skip n transparent pixels, 00 00 ends the bitmap
+// 01-7F:  that many literal pixels follow
+// 80-FF:  run of (c - 0x80) copies of the next byte
+// Skipped pixels are left untouched, so dst should be cleared first.
+// Returns the output position reached (at most dstSize).
+size_t decodeRLESprite(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+// DAT indexed sprite RLE (see SpriteIndex), decoded as rows of `width`
+// FF <byte> <count>: run of count + 1 copies of byte
+// 00:                end of row
+// Any other byte:    literal pixel
+// Pixels past the row width are dropped, and the rest of a short row is
+// left untouched, so dst should be cleared first. Returns the number of
+// rows reached (at most height).
+size_t decodeRLERows(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t width, size_t height);
+
+// GRP entry LZ (flag GRP_COMPRESSION_LZ)
+// Each flag byte covers the next 8 items, low bit first
+// Set bit: one literal byte
+// Clear bit: 16-bit little-endian reference, offset (ref >> 4) + 1 and
+// length (ref & 0x0F) + 3; bytes before the start of output read as zero
+// Literals and matches are copied in whole words and may write a few bytes
+// past the returned length (never past dstSize).
+size_t decodeLZ(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+} // namespace opengg
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+
+namespace opengg {
+
+// Lowercase a file or entry name, for case-insensitive lookups
+std::string toLower(std::string str);
+
+// Cached listing of asset directories, for resolving file paths without
+// touching the filesystem
+// Each directory is scanned once on first lookup (missing directories are
+// remembered as empty) and indexed by lowercase filename and by stem, so
+// path resolution is a hash lookup. Call refresh() after files change.
+// Thread-safe.
+class DirectoryIndex {
+public:
+    // Full path of a file in dir, matched case-insensitively; empty if absent
+    std::string find(const std::string& dir, const std::string& filename) const;
+
+    // Full path of the first file in dir (in name order) with the given stem
+    std::string findStem(const std::string& dir, const std::string& stem) const;
+
+    // Names of the regular files in dir, sorted
+    std::vector<std::string> list(const std::string& dir) const;
+
+    // Forget all scanned directories
+    void refresh();
+
+private:
+    struct Directory {
+        std::vector<std::string> names;                      // Sorted
+        std::unordered_map<std::string, size_t> byName;      // Lowercase name -> index
+        std::unordered_map<std::string, size_t> byStem;      // Lowercase stem -> index
+    };
+
+    const Directory& getDirectory(const std::string& dir) const;
+
+    mutable std::mutex mutex_;
+    mutable std::unordered_map<std::string, Directory> dirs_;
+};
+
+} // namespace opengg
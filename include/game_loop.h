@@ -37,6 +37,7 @@ struct GameConfig {
     bool fullscreen = false;
     bool vsync = true;
     int targetFPS = 60;
+    double assetUploadBudgetMs = 2.0;  // Per-frame time for streamed texture uploads
     std::string gamePath;   // Path to original game
     std::string cachePath;  // Path for asset cache
     std::string configPath; // Path for config files
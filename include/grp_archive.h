@@ -1,6 +1,7 @@
 #pragma once
 
 #include "formats/grp_format.h"
+#include "mapped_file.h"
 #include <string>
 #include <vector>
 #include <cstdint>
@@ -21,6 +22,13 @@ struct GrpEntry {
     bool isCompressed;
 };
 
+// Read-only view of an entry's bytes inside the mapped archive
+// Valid until the archive is closed or reopened
+struct GrpView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
 // Decoded sprite
 struct Sprite {
     int width;
@@ -57,12 +65,33 @@ public:
     // Extract raw file data
     std::vector<uint8_t> extract(const std::string& name);
 
+    // Get a zero-copy view of an uncompressed entry (data is nullptr on error)
+    GrpView view(const std::string& name);
+
+    // Decode an entry straight out of the mapping into a caller-supplied buffer
+    // dst must hold at least entry->size bytes; returns bytes written (0 on error)
+    size_t extractInto(const std::string& name, uint8_t* dst, size_t dstSize);
+
+    // Reentrant variants: safe to call from several threads at once on one open
+    // archive. They only read the shared mapping and report errors through
+    // `error` instead of getLastError().
+    bool extract(const std::string& name, std::vector<uint8_t>& out,
+                 std::string* error = nullptr) const;
+    GrpView view(const std::string& name, std::string* error) const;
+    size_t extractInto(const std::string& name, uint8_t* dst, size_t dstSize,
+                       std::string* error) const;
+
     // Extract and decode as sprite
     std::unique_ptr<Sprite> extractSprite(const std::string& name);
 
     // Extract as SDL_Surface (requires SDL2)
     SDL_Surface* extractAsSurface(const std::string& name);
 
+    // Decode an entry's stored bytes according to its compression flags
+    // Returns bytes written to dst (at most dstSize)
+    static size_t decodeEntry(uint8_t flags, const uint8_t* src, size_t srcSize,
+                              uint8_t* dst, size_t dstSize);
+
     // Set the palette to use for indexed sprites
     void setPalette(const std::vector<uint32_t>& palette);
 
@@ -72,11 +101,11 @@ public:
 private:
     bool parseHeader();
     bool parseFileTable();
-    std::vector<uint8_t> decompressRLE(const std::vector<uint8_t>& compressed, uint32_t uncompressedSize);
-    std::vector<uint8_t> decompressLZ(const std::vector<uint8_t>& compressed, uint32_t uncompressedSize);
-    std::unique_ptr<Sprite> decodeSprite(const std::vector<uint8_t>& data);
+    GrpView rawView(const GrpEntry& entry, std::string* error) const;
+    std::unique_ptr<Sprite> decodeSprite(const uint8_t* data, size_t size);
 
     std::string filePath_;
+    MappedFile mapping_;
     std::vector<GrpEntry> entries_;
     std::unordered_map<std::string, size_t> entryMap_;
     std::vector<uint32_t> palette_;
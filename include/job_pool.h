@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstddef>
+
+namespace opengg {
+
+// Fixed-size pool of worker threads running queued jobs in FIFO order
+// Used by AssetCache to read and decode assets off the main thread
+class JobPool {
+public:
+    // threadCount 0 picks one less than the hardware thread count (at least 1)
+    explicit JobPool(size_t threadCount = 0);
+
+    // Drops jobs that have not started and waits for running ones
+    ~JobPool();
+
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+
+    // Queue a job
+    void submit(std::function<void()> job);
+
+    // Block until the queue is empty and no job is running
+    void waitIdle();
+
+    size_t getThreadCount() const { return workers_.size(); }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> jobs_;
+    std::mutex mutex_;
+    std::condition_variable jobAvailable_;
+    std::condition_variable idle_;
+    size_t runningJobs_ = 0;
+    bool stopping_ = false;
+};
+
+} // namespace opengg
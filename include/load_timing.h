@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+namespace opengg {
+
+// Stages of an asset load, timed separately
+enum class LoadStage {
+    Resolve,        // Asset ID to catalog entry or file path
+    Read,           // Bytes from game files, extracted files or the cache pack
+    Decompress,     // GRP RLE/LZ decoding
+    Convert,        // BMP/WAV/sprite decoding and palette expansion
+    Upload          // Texture creation
+};
+
+constexpr size_t LOAD_STAGE_COUNT = 5;
+
+// Lowercase stage name ("resolve", "read", ...)
+const char* getLoadStageName(LoadStage stage);
+
+// Timing of a single load, filled in as it passes through each stage
+struct LoadTiming {
+    double stageMs[LOAD_STAGE_COUNT] = {};
+    uint64_t bytesFromDisk = 0;     // Game files and extracted files
+    uint64_t bytesFromCache = 0;    // Cache pack
+
+    void add(LoadStage stage, double ms) { stageMs[static_cast<size_t>(stage)] += ms; }
+    double getTotalMs() const;
+};
+
+// Adds the time from construction to stop() (or destruction) to one stage
+// of a LoadTiming. A null timing makes it a no-op.
+class StageTimer {
+public:
+    StageTimer(LoadTiming* timing, LoadStage stage);
+    ~StageTimer() { stop(); }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+    void stop();
+
+private:
+    LoadTiming* timing_;
+    LoadStage stage_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Latency histogram with logarithmic buckets, eight per power of two
+// (about 9% wide), from 1 us to about two minutes
+class LatencyHistogram {
+public:
+    void record(double ms);
+    void clear();
+
+    // Latency at or below which `fraction` (0-1) of the samples fall, in ms.
+    // Accurate to one bucket.
+    double getPercentile(double fraction) const;
+
+    size_t getCount() const { return count_; }
+    double getTotalMs() const { return totalMs_; }
+    double getMaxMs() const { return maxMs_; }
+
+private:
+    static constexpr size_t SUB_BUCKETS = 8;
+    static constexpr size_t BUCKET_COUNT = 1 + 27 * SUB_BUCKETS;   // Bucket 0 is < 1 us
+
+    uint32_t buckets_[BUCKET_COUNT] = {};
+    size_t count_ = 0;
+    double totalMs_ = 0.0;
+    double maxMs_ = 0.0;
+};
+
+// Latencies of every load of one asset class, in total and per stage
+struct LoadProfile {
+    LatencyHistogram total;
+    LatencyHistogram stages[LOAD_STAGE_COUNT];
+
+    void record(const LoadTiming& timing);
+};
+
+} // namespace opengg
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+
+namespace opengg {
+
+// Store an error for the caller of a reentrant method, if it asked for one
+inline void setError(std::string* error, const std::string& message) {
+    if (error) {
+        *error = message;
+    }
+}
+
+} // namespace opengg
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace opengg {
+
+// Read-only memory mapping of a whole file
+// Lets the archive loaders hand out pointers into game data without
+// reopening the file or copying bytes for every resource
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map a file into memory (read-only)
+    bool open(const std::string& path);
+
+    // Unmap and close the file
+    void close();
+
+    // Check if a file is mapped
+    bool isOpen() const { return isOpen_; }
+
+    // Base pointer and length of the mapping
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    // Bounds-checked pointer to [offset, offset + length), nullptr if out of range
+    const uint8_t* at(size_t offset, size_t length) const;
+
+    // Get last error
+    std::string getLastError() const { return lastError_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool isOpen_ = false;
+
+#ifdef _WIN32
+    void* fileHandle_ = nullptr;
+    void* mappingHandle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+
+    std::string lastError_;
+};
+
+} // namespace opengg
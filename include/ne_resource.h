@@ -1,9 +1,11 @@
 #pragma once
 
 #include "formats/ne_format.h"
+#include "mapped_file.h"
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <unordered_map>
 
 namespace opengg {
 
@@ -18,6 +20,18 @@ struct Resource {
     std::string name;  // If named resource
 };
 
+// Contiguous view of the resources of one type
+// Valid until the file is closed or reopened
+struct ResourceRange {
+    const Resource* first = nullptr;
+    const Resource* last = nullptr;
+
+    const Resource* begin() const { return first; }
+    const Resource* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+};
+
 // NE (New Executable) Resource Extractor
 // Used for extracting resources from .DAT and .RSC files which are NE DLLs
 class NEResourceExtractor {
@@ -31,8 +45,11 @@ public:
     // List all resources in the file
     std::vector<Resource> listResources() const;
 
-    // List resources of a specific type
-    std::vector<Resource> listResourcesByType(uint16_t type) const;
+    // List resources of a specific type (view, no copy)
+    ResourceRange listResourcesByType(uint16_t type) const;
+
+    // Find a resource by type and ID (nullptr if missing)
+    const Resource* findResource(uint16_t type, uint16_t id) const;
 
     // Extract a resource by type and ID
     std::vector<uint8_t> extractResource(uint16_t type, uint16_t id);
@@ -40,6 +57,17 @@ public:
     // Extract a resource by descriptor
     std::vector<uint8_t> extractResource(const Resource& res);
 
+    // Reentrant variants: safe to call from several threads at once on one open
+    // file. They copy out of the shared mapping and report errors through
+    // `error` instead of getLastError().
+    bool readResource(uint16_t type, uint16_t id, std::vector<uint8_t>& out,
+                      std::string* error = nullptr) const;
+    bool readResource(const Resource& res, std::vector<uint8_t>& out,
+                      std::string* error = nullptr) const;
+
+    // Get display name for a resource type ID (e.g. "BITMAP", "CUSTOM_32513")
+    static std::string getResourceTypeName(uint16_t typeId);
+
     // Extract a bitmap resource and save as BMP file
     bool extractBitmap(uint16_t id, const std::string& outPath);
 
@@ -47,11 +75,22 @@ public:
     std::string getLastError() const;
 
 private:
-    std::vector<uint8_t> extractResourceByOffset(uint32_t offset, uint32_t size);
-    std::string getResourceTypeName(uint16_t typeId) const;
+    bool readAt(uint32_t offset, uint32_t size, std::vector<uint8_t>& out,
+                std::string* error) const;
+    void buildIndex();
+
+    static uint32_t indexKey(uint16_t type, uint16_t id) {
+        return (static_cast<uint32_t>(type) << 16) | id;
+    }
 
     std::string filePath_;
+    MappedFile mapping_;
     std::vector<Resource> resources_;
+
+    // Lookup tables built at open(): (type,id) -> index into resources_,
+    // and type -> [begin, end) range (resources_ is grouped by type)
+    std::unordered_map<uint32_t, uint32_t> resourceIndex_;
+    std::unordered_map<uint16_t, std::pair<uint32_t, uint32_t>> typeRanges_;
     uint32_t neHeaderOffset_ = 0;
     uint16_t alignmentShift_ = 0;
     std::string lastError_;
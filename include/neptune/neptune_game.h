@@ -13,6 +13,7 @@ class Renderer;
 class AudioSystem;
 class InputSystem;
 class AssetCache;
+struct TextureRequest;
 
 // Neptune game section types
 enum class NeptuneSection {
@@ -166,6 +167,8 @@ public:
 
 private:
     void loadAssets();
+    void resolveAssets();
+    void releaseAssets();
     void loadRooms();
 
     void updateSubmarine(float dt);
@@ -198,6 +201,14 @@ private:
     SDL_Texture* fuelStationTexture_ = nullptr;
     SDL_Texture* hudTexture_ = nullptr;
 
+    // Texture loads still streaming in, in order of preference
+    std::vector<std::shared_ptr<TextureRequest>> submarineRequests_;
+    std::vector<std::shared_ptr<TextureRequest>> backgroundRequests_;
+
+    // Requests whose textures are in use (each holds a cache reference)
+    std::shared_ptr<TextureRequest> submarineRequest_;
+    std::shared_ptr<TextureRequest> backgroundRequest_;
+
     // Puzzle state
     int currentPuzzleId_ = -1;
 };
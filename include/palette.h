@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace opengg {
+
+// Pixel expansion kernels for indexed and BGR bitmaps
+// Every kernel writes `count` 32-bit ARGB values (0xAARRGGBB, i.e.
+// SDL_PIXELFORMAT_ARGB8888) into dst, so rows can go straight into a locked
+// texture. All but expandBGRA32 write opaque pixels. Assumes a
+// little-endian host. Palette lookups go through a 256-entry table built
+// once per palette.
+
+// Build an ARGB lookup table from BMP palette entries (B, G, R, reserved)
+// Entries at or past colorCount (at most 256 are read) are opaque black.
+void buildPaletteLUT(const uint8_t* bgrx, size_t colorCount, uint32_t lut[256]);
+
+// 8 bpp indices (AVX2 gather where the CPU has it)
+void expandPalette8(const uint8_t* src, uint32_t* dst, size_t count, const uint32_t lut[256]);
+
+// 4 bpp indices, high nibble first
+void expandPalette4(const uint8_t* src, uint32_t* dst, size_t count, const uint32_t lut[256]);
+
+// 1 bpp indices, most significant bit first
+void expandPalette1(const uint8_t* src, uint32_t* dst, size_t count, const uint32_t lut[256]);
+
+// 24-bit B, G, R pixels
+void expandBGR24(const uint8_t* src, uint32_t* dst, size_t count);
+
+// 32-bit B, G, R, x pixels (the fourth byte is ignored)
+void expandBGRX32(const uint8_t* src, uint32_t* dst, size_t count);
+
+// 32-bit B, G, R, A pixels (copied as they are)
+void expandBGRA32(const uint8_t* src, uint32_t* dst, size_t count);
+
+// Uncompressed 1/4/8/24/32 bpp bitmap located by parseBitmap()
+struct BitmapView {
+    const uint8_t* pixels = nullptr;    // Stored rows, bottom-up unless topDown
+    size_t rowStride = 0;               // Bytes per stored row (4-byte aligned)
+    int width = 0;
+    int height = 0;
+    bool topDown = false;
+    bool hasAlpha = false;              // 32 bpp rows carry an alpha channel
+    uint16_t bitCount = 0;
+    uint32_t lut[256];                  // ARGB palette of indexed bitmaps
+};
+
+// Locate the rows and palette of a BMP file (with its BITMAPFILEHEADER)
+// or of a bare BITMAPINFOHEADER resource, checking they fit in size bytes.
+// Compressed, 16 bpp and OS/2 bitmaps are rejected; SDL_LoadBMP can read
+// those. 32 bpp bitmaps keep their alpha when a V3+ header has an alpha
+// mask, or, without a mask, when any alpha byte is set (as SDL_LoadBMP
+// does). The view points into data.
+bool parseBitmap(const uint8_t* data, size_t size, BitmapView& bitmap, std::string* error = nullptr);
+
+// Expand a parsed bitmap into ARGB8888 rows, top row first, pitch bytes apart
+void expandBitmap(const BitmapView& bitmap, uint8_t* dst, size_t pitch);
+
+} // namespace opengg
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "entity.h"
+#include "asset_handle.h"
 #include "formats/dat_format.h"
 #include <vector>
 #include <array>
@@ -109,7 +110,7 @@ public:
     void addScore(int points);
 
     // Audio
-    void setAudioSystem(AudioSystem* audio) { audio_ = audio; }
+    void setAudioSystem(AudioSystem* audio);
 
     // Interaction
     void interact();  // Try to interact with nearby objects
@@ -176,8 +177,19 @@ private:
     // Puzzles
     int currentPuzzleId_ = -1;
 
-    // Audio
+    // Audio (sound handles resolved in setAudioSystem)
     AudioSystem* audio_ = nullptr;
+    struct Sounds {
+        AssetHandle jump;
+        AssetHandle partCollect;
+        AssetHandle doorOpen;
+        AssetHandle doorLocked;
+        AssetHandle puzzleComplete;
+        AssetHandle hurt;
+        AssetHandle gameOver;
+        AssetHandle extraLife;
+    };
+    Sounds sounds_;
 };
 
 } // namespace opengg
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "formats/dat_format.h"
+#include "asset_handle.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -58,7 +59,7 @@ public:
 
 protected:
     void complete(PuzzleResult result);
-    void playSound(const std::string& sound);
+    void playSound(AssetHandle sound);
 
     PuzzleType type_ = PuzzleType::Balance;
     int difficulty_ = 1;
@@ -105,6 +106,9 @@ private:
     int targetBalance_ = 0;
     float balanceAngle_ = 0.0f;
     int selectedWeight_ = -1;
+
+    AssetHandle clickSound_;
+    AssetHandle placeSound_;
 };
 
 // Electricity puzzle - complete the circuit
@@ -167,6 +171,9 @@ private:
     int driverGear_ = 0;
     int outputGear_ = 0;
     int selectedGear_ = -1;
+
+    AssetHandle clickSound_;
+    AssetHandle placeSound_;
 };
 
 // Jigsaw puzzle
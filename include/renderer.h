@@ -14,6 +14,7 @@ struct SDL_Rect;
 namespace opengg {
 
 struct Sprite;
+struct AtlasRegion;
 
 // Color structure
 struct Color {
@@ -141,6 +142,9 @@ public:
     // Sprite drawing with palette-based sprite data
     void drawSprite(const Sprite& sprite, int x, int y);
 
+    // Sprite packed in a texture atlas page (see AssetCache::buildAtlas)
+    void drawSprite(const AtlasRegion& region, int x, int y);
+
     // Primitive drawing
     void drawRect(const Rect& rect, const Color& color);
     void fillRect(const Rect& rect, const Color& color);
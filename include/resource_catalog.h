@@ -0,0 +1,140 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+
+namespace opengg {
+
+class MappedFile;
+struct LoadTiming;
+
+// Container format of a catalogued game file
+enum class CatalogFileKind : uint8_t {
+    NE = 0,     // .DAT / .RSC / .DLL resource file
+    GRP = 1     // RGrp archive
+};
+
+#pragma pack(push, 1)
+
+// Catalog file header
+struct CatalogHeader {
+    char     magic[4];          // "OGRC"
+    uint32_t version;
+    uint32_t fileCount;
+    uint32_t entryCount;
+    uint32_t stringPoolSize;
+    uint32_t gamePathOffset;    // Game root the catalog was built for
+};
+
+// One catalogued game file
+struct CatalogFile {
+    uint32_t nameOffset;        // Lowercase filename in the string pool
+    uint32_t pathOffset;        // Full path in the string pool
+    uint64_t fileSize;
+    int64_t  modifiedTime;      // Filesystem timestamp at build time
+    uint32_t firstEntry;        // Index of the file's first entry
+    uint32_t entryCount;
+    uint8_t  kind;              // CatalogFileKind
+    uint8_t  reserved[7];
+};
+
+// One catalogued resource (NE resource or GRP entry)
+struct CatalogEntry {
+    uint32_t fileIndex;
+    uint32_t offset;            // Offset of the stored bytes in the file
+    uint32_t size;              // Stored size in the file
+    uint32_t decodedSize;       // Size after decompression (same as size for NE)
+    uint16_t type;              // NE type ID (0 for GRP entries)
+    uint16_t id;                // NE resource ID (0 for GRP entries)
+    uint32_t nameOffset;        // Lowercase GRP entry name, or NE resource name
+    uint32_t crc32;             // CRC of the stored bytes
+    uint16_t flags;             // NE resource flags or GRP compression flags
+    uint16_t reserved;
+};
+
+#pragma pack(pop)
+
+// Prebuilt catalog of every resource in every game file under a game root
+// Built once by scanning the game directories, then saved to the cache
+// directory and reloaded with a single read on later startups, so asset
+// lookups skip directory probing and NE/GRP header parsing.
+class ResourceCatalog {
+public:
+    ResourceCatalog();
+    ~ResourceCatalog();
+
+    // Scan gamePath/<dir> for NE and GRP files (dirs in priority order,
+    // "" means the root itself) and catalog all their resources. Files
+    // whose size and timestamp match the current catalog are carried over
+    // without being read again.
+    bool build(const std::string& gamePath, const std::vector<std::string>& searchDirs);
+
+    // Load/save the serialized catalog
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    // True if built for another game root, or a catalogued file changed
+    bool isStale(const std::string& gamePath) const;
+
+    // Drop all catalog data
+    void clear();
+
+    bool empty() const { return files_.empty(); }
+    size_t getFileCount() const { return files_.size(); }
+    size_t getEntryCount() const { return entries_.size(); }
+
+    // Find a file by name (case-insensitive, first match in search order)
+    const CatalogFile* findFile(const std::string& filename) const;
+
+    // Find an NE resource by type and ID
+    const CatalogEntry* findResource(const std::string& filename, uint16_t type, uint16_t id) const;
+
+    // Find a GRP entry by name (case-insensitive)
+    const CatalogEntry* findEntry(const std::string& filename, const std::string& entryName) const;
+
+    // All entries of a file
+    const CatalogEntry* entriesBegin(const CatalogFile& file) const;
+    const CatalogEntry* entriesEnd(const CatalogFile& file) const;
+
+    // String accessors
+    std::string getFilePath(const CatalogFile& file) const;
+    std::string getEntryName(const CatalogEntry& entry) const;
+
+    // Read an entry's bytes (GRP entries are decompressed). Thread-safe.
+    // Read and decompress times and the bytes read are added to timing.
+    // Empty entries fail like missing ones.
+    bool read(const CatalogEntry& entry, std::vector<uint8_t>& out,
+              std::string* error = nullptr, LoadTiming* timing = nullptr) const;
+
+    // Get last error
+    std::string getLastError() const { return lastError_; }
+
+private:
+    bool addNEFile(const std::string& path);
+    bool addGrpFile(const std::string& path);
+    bool reuseFile(const ResourceCatalog& previous, const std::string& path);
+    uint32_t addString(const std::string& str);
+    const char* getString(uint32_t offset) const;
+    void buildFileMap();
+    const MappedFile* getMapping(uint32_t fileIndex) const;
+
+    std::vector<CatalogFile> files_;
+    std::vector<CatalogEntry> entries_;
+    std::vector<char> strings_;
+    uint32_t gamePathOffset_ = 0;
+
+    // Lowercase filename -> file index
+    std::unordered_map<std::string, uint32_t> fileMap_;
+
+    // Game files mapped on first read
+    mutable std::mutex mappingMutex_;
+    mutable std::vector<std::unique_ptr<MappedFile>> mappings_;
+
+    std::string lastError_;
+};
+
+} // namespace opengg
@@ -5,6 +5,10 @@
 #include <cstdint>
 #include <memory>
 #include <fstream>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 
 struct SDL_Texture;
 struct SDL_Renderer;
@@ -20,8 +24,53 @@ struct SmackerAudioInfo {
     bool isCompressed;
 };
 
+// Read-only view of one frame's decoded audio: interleaved 16-bit samples
+// (count covers all channels). Valid until the next frame is decoded.
+struct SmackerAudioView {
+    const int16_t* samples = nullptr;
+    size_t count = 0;
+};
+
+// Pixel format of the frames the playback thread delivers
+enum class SmackerPixelFormat {
+    ARGB8888,   // 32-bit pixels, as SDL_PIXELFORMAT_ARGB8888
+    Indexed8    // Palette indices plus the frame's palette, for 8-bit compositing
+};
+
+// A frame decoded by the playback thread
+struct SmackerFrame {
+    uint32_t index = 0;             // Frame number
+    double time = 0.0;              // Presentation time, seconds from the start of the video
+    SmackerPixelFormat format = SmackerPixelFormat::ARGB8888;
+    std::vector<uint32_t> argb;     // width * height pixels (ARGB8888)
+    std::vector<uint8_t> indexed;   // width * height palette indices (Indexed8)
+    uint32_t palette[256] = {};     // ARGB palette of the frame (Indexed8)
+};
+
+// How seekToFrame() lands
+enum class SmackerSeekMode {
+    Exact,      // On the requested frame (decodes forward from the keyframe before it)
+    KeyFrame    // On the nearest keyframe at or before it (for scrubbing)
+};
+
+// Time spent in each decoding stage, added up while attached to a player
+// with setDecodeStats(). Huffman decoding of the video is interleaved with
+// writing the blocks it codes, so both count as video.
+struct SmackerDecodeStats {
+    double treesMs = 0.0;       // Header Huffman trees to lookup tables (on open)
+    double readMs = 0.0;        // File reads
+    double paletteMs = 0.0;     // Palette chunks
+    double audioMs = 0.0;       // Audio chunks (PCM copy or DPCM decoding)
+    double videoMs = 0.0;       // Huffman-coded blocks into the indexed frame
+    uint64_t bytesRead = 0;
+    uint32_t frames = 0;
+};
+
 // Smacker video decoder
-// Decodes RAD Game Tools Smacker (.SMK) video files
+// Decodes RAD Game Tools Smacker (.SMK) video files, versions 2 and 4.
+// The four Huffman trees in the file header (MMAP, MCLR, FULL, TYPE) are
+// parsed once on open into multi-bit lookup tables; frames are then decoded
+// block by block with a 64-bit buffered bit reader.
 class SmackerPlayer {
 public:
     SmackerPlayer();
@@ -47,46 +96,138 @@ public:
     // Get frame rate (frames per second)
     float getFrameRate() const;
 
+    // Presentation time of a frame, in seconds from the start
+    double getFrameTime(uint32_t frame) const;
+
     // Get audio info for a track (0-6)
     SmackerAudioInfo getAudioInfo(int track) const;
 
     // Decode next frame - returns false if no more frames
     bool nextFrame();
 
-    // Get current frame pixels (RGB format)
-    const std::vector<uint8_t>& getFrameRGB() const { return frameRGB_; }
+    // Get current frame pixels (RGB format), converted on first call
+    const std::vector<uint8_t>& getFrameRGB() const;
+
+    // Current frame as palette indices (width * height), and its palette
+    // as 256 RGB triplets and as ARGB values
+    const std::vector<uint8_t>& getFrameIndexed() const { return frameBuffer_; }
+    const std::vector<uint8_t>& getPalette() const { return palette_; }
+    const uint32_t* getPaletteARGB() const { return paletteLUT_; }
+
+    // 4x4 blocks whose indices the last nextFrame() changed, one byte per
+    // block (nonzero = changed), row by row; after a seek or rewind every
+    // block is marked. Rows past the last whole block row never change.
+    const std::vector<uint8_t>& getChangedBlocks() const { return changedBlocks_; }
+    int getBlocksWide() const { return width_ / 4; }
+
+    // True when the last nextFrame() (or a seek or rewind) changed the palette
+    bool paletteChanged() const { return paletteChanged_; }
 
-    // Get current frame as SDL texture
+    // Get current frame as SDL texture (ARGB8888). Palette indices are
+    // expanded straight into the locked texture, and only block rows that
+    // changed since the previous call are locked and written.
     SDL_Texture* getFrameTexture(SDL_Renderer* renderer);
 
-    // Get audio samples for current frame (16-bit signed)
-    std::vector<int16_t> getAudioSamples(int track);
+    // Get audio samples for current frame (16-bit signed), without copying
+    SmackerAudioView getAudioSamples(int track) const;
+
+    // Streaming audio: every decoded chunk of `track` is also pushed into a
+    // lock-free ring (about two seconds long) that the audio device drains
+    // through readAudio() or audioCallback(), converted to the device's
+    // rate and channel count. Enable and disable while the device isn't
+    // pulling from this player (e.g. before AudioSystem::hookStream()).
+    bool enableAudioStream(int track, int outputRate, int outputChannels);
+    void disableAudioStream();
+    bool hasAudioStream() const { return audioTrack_ >= 0; }
+
+    // Audio thread: write `frames` frames of interleaved 16-bit output.
+    // Never blocks or allocates; missing samples are written as silence.
+    // Returns the frames that came from the stream.
+    size_t readAudio(int16_t* out, size_t frames);
+
+    // SDL audio callback (Mix_HookMusic / SDL_AudioSpec) with the player as
+    // userdata
+    static void audioCallback(void* player, uint8_t* stream, int bytes);
+
+    // Seconds of streamed audio the device has consumed, from the start of
+    // the video; this is the video clock while streaming
+    double getAudioClock() const;
 
     // Reset to beginning
     void rewind();
 
-    // Seek to specific frame
-    bool seekToFrame(uint32_t frame);
+    // Seek so that the next nextFrame() decodes `frame` (or, with
+    // SmackerSeekMode::KeyFrame, the keyframe at or before it). Decoding
+    // restarts from the nearest keyframe, or carries on from the current
+    // frame when that is closer.
+    bool seekToFrame(uint32_t frame, SmackerSeekMode mode = SmackerSeekMode::Exact);
+
+    // Frames that decode without the previous frame (frame 0 and those
+    // flagged in the frame size table), in order
+    const std::vector<uint32_t>& getKeyFrames() const { return keyFrames_; }
+
+    // Threaded playback: a decoder thread reads ahead from the current
+    // frame and decodes into a ring of ringFrames preallocated frames.
+    // While it runs, nextFrame(), seekToFrame() and rewind() fail, and the
+    // per-frame audio buffers belong to the thread. Decode errors end playback
+    // and are reported by getLastError() after stopPlayback().
+    bool startPlayback(size_t ringFrames = 8,
+                       SmackerPixelFormat format = SmackerPixelFormat::ARGB8888);
+
+    // Stop the thread and drop undelivered frames; the next nextFrame()
+    // continues after the last frame the thread decoded
+    void stopPlayback();
+
+    bool isPlaying() const { return decodeThread_.joinable(); }
+
+    // Newest decoded frame due at `time` (seconds from the start), or
+    // nullptr if none is due yet. Older due frames are dropped. The frame
+    // stays valid until releaseFrame(); acquire at most one at a time.
+    // Lock-free: call from one consumer thread.
+    const SmackerFrame* acquireFrame(double time);
+    void releaseFrame(const SmackerFrame* frame);
+
+    // Same, timed by getAudioClock() (needs enableAudioStream()). Once the
+    // audio has run out, the remaining frames are handed out one per call.
+    const SmackerFrame* acquireFrame();
+
+    // True once the thread has decoded the last frame and all were delivered
+    bool isPlaybackFinished() const;
+
+    // Frames skipped by acquireFrame() because a later one was already due
+    uint32_t getDroppedFrames() const { return droppedFrames_; }
+
+    // Upload a frame from acquireFrame() to the cached texture
+    SDL_Texture* getFrameTexture(SDL_Renderer* renderer, const SmackerFrame& frame);
+
+    // Collect stage timings into `stats` (nullptr to stop). Attach before
+    // open() to include the header trees.
+    void setDecodeStats(SmackerDecodeStats* stats) { stats_ = stats; }
 
     // Get last error
     std::string getLastError() const { return lastError_; }
 
 private:
-    struct TreeNode;
+    struct BigTree;
 
     bool readHeader();
     bool readFrameSizes();
+    bool readTrees(const uint8_t* data, size_t size);
     bool decodeFrame(uint32_t frameIndex);
+    const uint8_t* readFrame(uint32_t frameIndex, size_t size);
+    void convertFrame(uint8_t* rgb) const;
+    bool createTexture(SDL_Renderer* renderer);
+    void playbackLoop();
+    void markAllChanged();
+    void updatePaletteLUT();
+    void resetPalette();
+    bool restorePalette(size_t keyFrame);
     bool decodePalette(const uint8_t* data, size_t size);
     bool decodeVideo(const uint8_t* data, size_t size);
     bool decodeAudio(const uint8_t* data, size_t size, int track);
-
-    // Huffman tree operations
-    std::unique_ptr<TreeNode> buildTree(const uint8_t*& data, size_t& remaining);
-    int decodeTreeValue(TreeNode* tree, const uint8_t*& data, int& bitPos);
-
-    // Bit reading helpers
-    uint32_t readBits(const uint8_t*& data, int& bitPos, int numBits);
+    bool decodeDPCM(const uint8_t* data, size_t size, int track);
+    void pushAudio(const int16_t* samples, size_t count);
+    void flushAudio(double time);
 
     std::string filePath_;
     std::ifstream file_;
@@ -99,29 +240,90 @@ private:
     int32_t frameRateNum_ = 0;
     int32_t frameRateDen_ = 1;
 
+    uint32_t flags_ = 0;
+    bool isV4_ = false;
+
     // Frame data
     std::vector<uint32_t> frameSizes_;
     std::vector<uint8_t> frameTypes_;
+    std::vector<uint64_t> frameOffsets_;    // File offset of each frame, plus the end
+    std::vector<uint8_t> readAhead_;        // File bytes from readAheadOffset_ on
+    uint64_t readAheadOffset_ = 0;
     uint32_t treeSize_ = 0;
+    uint32_t bigTreeSizes_[4] = {};         // MMAP, MCLR, FULL, TYPE
+
+    // Decoding trees, in the same order
+    std::unique_ptr<BigTree> trees_[4];
 
     // Decoded frame (indexed color)
     std::vector<uint8_t> frameBuffer_;
 
-    // Current palette (256 RGB entries)
+    // Current palette (256 RGB entries), and as ARGB
     std::vector<uint8_t> palette_;
+    uint32_t paletteLUT_[256] = {};
 
-    // RGB output
-    std::vector<uint8_t> frameRGB_;
+    // What changed: blocks in the last frame, and block rows (one per 4
+    // pixel rows, rounded up) since the texture was last written
+    std::vector<uint8_t> changedBlocks_;
+    std::vector<uint8_t> textureRows_;
+    bool paletteChanged_ = false;
+    bool clearChanges_ = false;             // False until the next frame after a seek
+
+    // Keyframes, and the palette in effect before each one (empty until
+    // first needed)
+    std::vector<uint32_t> keyFrames_;
+    std::vector<std::vector<uint8_t>> keyPalettes_;
+
+    // RGB output, filled by getFrameRGB()
+    mutable std::vector<uint8_t> frameRGB_;
+    mutable bool frameRGBValid_ = false;
 
     // Audio tracks
     SmackerAudioInfo audioInfo_[7];
     std::vector<int16_t> audioBuffers_[7];
 
+    // Audio stream ring (source samples, interleaved). head and tail count
+    // samples pushed and consumed; samples before flushTo were dropped by a
+    // seek, and the clock reads baseTime at flushTo.
+    int audioTrack_ = -1;
+    unsigned audioChannels_ = 1;
+    uint32_t audioRate_ = 0;
+    int outputChannels_ = 2;
+    uint32_t audioStep_ = 0;                // Source frames per output frame, 16.16
+    uint32_t audioFraction_ = 0;            // Audio thread only
+    std::vector<int16_t> audioRing_;
+    std::atomic<uint64_t> audioHead_{0};
+    std::atomic<uint64_t> audioTail_{0};
+    std::atomic<uint64_t> audioFlushTo_{0};
+    std::atomic<double> audioBaseTime_{0.0};
+
+    // Playback ring: slots [tail, head) hold decoded frames. The thread
+    // only advances head and the consumer only advances tail.
+    std::vector<SmackerFrame> ring_;
+    std::atomic<uint64_t> ringHead_{0};
+    std::atomic<uint64_t> ringTail_{0};
+    std::atomic<bool> producerWaiting_{false};
+    std::atomic<bool> stopDecode_{false};
+    std::atomic<bool> decodeDone_{false};
+    std::atomic<uint32_t> droppedFrames_{0};
+    std::mutex ringMutex_;
+    std::condition_variable ringSpace_;     // Only waited on while the ring is full
+    std::thread decodeThread_;
+    uint32_t decodeNext_ = 0;               // Next frame for the thread
+    SmackerPixelFormat ringFormat_ = SmackerPixelFormat::ARGB8888;
+
+    SmackerDecodeStats* stats_ = nullptr;
+
     // Internal state
     uint32_t dataOffset_ = 0;
     bool isOpen_ = false;
     std::string lastError_;
 
+    // Errors of the decode path, which the playback thread also runs; copied
+    // to lastError_ by synchronous callers, and by stopPlayback() after the
+    // thread has joined
+    std::string decodeError_;
+
     // SDL texture (cached)
     SDL_Texture* texture_ = nullptr;
 };
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace opengg {
+
+// Sprite compiled to opaque spans
+// Each row is a list of spans (x offset and length, in x order) over the
+// non-transparent pixels; the pixel bytes of all spans are stored back to
+// back. Index 0 is transparent and never stored, so a mostly transparent
+// character frame costs a fraction of its width * height, and blitting it
+// never reads or writes the pixels around the figure.
+struct SpanSprite {
+    struct Span {
+        uint16_t x;
+        uint16_t length;
+    };
+
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> rowSpans;     // height + 1 entries: first span of each row
+    std::vector<uint32_t> rowPixels;    // height + 1 entries: first pixel of each row
+    std::vector<Span> spans;
+    std::vector<uint8_t> pixels;        // Palette indices, span after span
+
+    bool empty() const { return spans.empty(); }
+    size_t getMemoryUsage() const;
+};
+
+// Compile decoded palette indices (width * height, top row first)
+bool compileSpans(const uint8_t* indexed, int width, int height, SpanSprite& out);
+
+// Compile DAT sprite RLE (see decodeRLEEscapeFF) without decoding it first.
+// The stream is one run of width * height pixels; runs of index 0 are skipped.
+bool compileSpansEscapeFF(const uint8_t* src, size_t srcSize, int width, int height, SpanSprite& out);
+
+// Compile DAT indexed sprite RLE (see decodeRLERows), row by row
+bool compileSpansRows(const uint8_t* src, size_t srcSize, int width, int height, SpanSprite& out);
+
+// Draw a sprite with its top-left corner at (x, y), clipped to the target.
+// pitch is in bytes, as in SDL_Surface. Only opaque pixels are written.
+void blitSpans8(const SpanSprite& sprite, uint8_t* dst, int pitch, int dstWidth, int dstHeight,
+                int x, int y);
+
+// Same into a 32-bit ARGB target, expanding through a palette lookup table
+// (see buildPaletteLUT)
+void blitSpans32(const SpanSprite& sprite, uint32_t* dst, int pitch, int dstWidth, int dstHeight,
+                 int x, int y, const uint32_t lut[256]);
+
+} // namespace opengg
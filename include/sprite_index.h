@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace opengg {
+
+class MappedFile;
+struct SpanSprite;
+
+#pragma pack(push, 1)
+
+// Sprite index file header
+struct SpriteIndexFileHeader {
+    char     magic[4];          // "OGSI"
+    uint32_t version;
+    uint64_t sourceSize;        // DAT file the index was built from
+    int64_t  sourceModifiedTime;
+    uint32_t animationCount;
+    uint32_t frameCount;
+};
+
+// One animation: a CUSTOM_32513 sprite table named by the ASEQ table
+struct SpriteAnimation {
+    uint16_t id;                // Resource ID (the ASEQ sequence ID)
+    uint16_t paletteId;         // CUSTOM_32514 palette listed in the LT table (0 = game palette)
+    uint32_t firstFrame;        // Index of its first frame
+    uint32_t frameCount;
+};
+
+// One RLE-encoded sprite frame
+struct SpriteFrame {
+    uint32_t offset;            // Absolute offset of the RLE data in the DAT file
+    uint32_t rleSize;           // Bytes up to the next frame (or the table's end)
+    uint16_t width;             // Longest row
+    uint16_t height;            // Row count
+    uint16_t animationId;
+    uint16_t frameIndex;        // Within its animation
+};
+
+#pragma pack(pop)
+
+// Flat index of every sprite frame in a Gizmos & Gadgets DAT file
+// Built once from the ASEQ and LT tables and the CUSTOM_32513 sprite tables
+// they name (frame offsets, plus dimensions measured from each frame's
+// rows), then saved to the cache directory. Fetching a frame is then an
+// array lookup and one decode straight from the mapped DAT file.
+// Sprite IDs index the frame array, in animation ID then frame order.
+class SpriteIndex {
+public:
+    SpriteIndex();
+    ~SpriteIndex();
+
+    SpriteIndex(const SpriteIndex&) = delete;
+    SpriteIndex& operator=(const SpriteIndex&) = delete;
+
+    // Parse the sprite tables of an NE DAT file (falls back to every
+    // CUSTOM_32513 resource if the file has no ASEQ table)
+    bool build(const std::string& datPath);
+
+    // Load an index saved for datPath; fails if the DAT file changed since
+    bool load(const std::string& path, const std::string& datPath);
+    bool save(const std::string& path) const;
+
+    bool empty() const { return frames_.empty(); }
+    size_t getFrameCount() const { return frames_.size(); }
+    size_t getAnimationCount() const { return animations_.size(); }
+    const std::vector<SpriteAnimation>& getAnimations() const { return animations_; }
+
+    // Frame by sprite ID (nullptr if out of range)
+    const SpriteFrame* getFrame(uint32_t spriteId) const;
+
+    // Animation by ID, and one of its frames (nullptr if missing)
+    const SpriteAnimation* findAnimation(uint16_t animationId) const;
+    const SpriteFrame* findFrame(uint16_t animationId, uint16_t frameIndex) const;
+
+    // Decode a frame to width * height palette indices, top row first.
+    // Index 0 is transparent. Thread-safe.
+    bool decodeFrame(const SpriteFrame& frame, std::vector<uint8_t>& pixels) const;
+
+    // Compile a frame straight to opaque spans (see span_sprite.h), without
+    // a full-size buffer. Thread-safe.
+    bool compileFrame(const SpriteFrame& frame, SpanSprite& sprite) const;
+
+    // Get last error
+    std::string getLastError() const { return lastError_; }
+
+private:
+    bool mapSource(const std::string& datPath);
+    void clear();
+
+    std::string datPath_;
+    uint64_t sourceSize_ = 0;
+    int64_t sourceModifiedTime_ = 0;
+    std::unique_ptr<MappedFile> mapping_;
+
+    std::vector<SpriteAnimation> animations_;   // Sorted by ID
+    std::vector<SpriteFrame> frames_;
+    std::string lastError_;
+};
+
+} // namespace opengg
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+
+struct SDL_Texture;
+struct SDL_Surface;
+struct SDL_Renderer;
+
+namespace opengg {
+
+// Rectangle packer using the skyline bottom-left heuristic
+// The packed area is tracked as a list of horizontal segments (the
+// "skyline"); each rectangle goes where its top edge ends up lowest.
+// Works best when rectangles are added tallest first.
+class SkylinePacker {
+public:
+    SkylinePacker(int width, int height);
+
+    // Find room for a width x height rectangle; false if it doesn't fit
+    bool pack(int width, int height, int& outX, int& outY);
+
+    // Forget everything packed so far
+    void reset();
+
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+
+    // Area taken by packed rectangles
+    size_t getUsedArea() const { return usedArea_; }
+
+private:
+    struct Segment {
+        int x;
+        int y;
+        int width;
+    };
+
+    // Top edge of a width-wide rectangle placed at segment index, or -1
+    int fitAt(size_t index, int width, int height) const;
+
+    int width_;
+    int height_;
+    std::vector<Segment> skyline_;     // Left to right, covering the full width
+    size_t usedArea_ = 0;
+};
+
+// Location of a sprite inside an atlas page
+struct AtlasRegion {
+    SDL_Texture* texture = nullptr;     // Page texture
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+// Set of large textures ("pages") holding many sprites each
+// Drawing several sprites from one page needs no texture switches between
+// them. Sprites are copied in as ARGB8888; one larger than a page gets a
+// page of its own.
+class TextureAtlas {
+public:
+    explicit TextureAtlas(SDL_Renderer* renderer, int pageSize = 2048);
+    ~TextureAtlas();
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    // Copy a surface into the atlas under key (a key already present keeps
+    // its region)
+    bool add(const std::string& key, SDL_Surface* surface);
+
+    // Region of a packed sprite, or null
+    const AtlasRegion* find(const std::string& key) const;
+
+    size_t getSpriteCount() const { return regions_.size(); }
+    size_t getPageCount() const { return pages_.size(); }
+
+    // Texture memory held by all pages
+    size_t getMemoryBytes() const;
+
+    // Get last error
+    std::string getLastError() const { return lastError_; }
+
+private:
+    struct Page {
+        SDL_Texture* texture;
+        SkylinePacker packer;
+    };
+
+    bool addPage(int width, int height);
+
+    SDL_Renderer* renderer_;
+    int pageSize_;
+    std::vector<Page> pages_;
+    std::unordered_map<std::string, AtlasRegion> regions_;
+    std::string lastError_;
+};
+
+} // namespace opengg
@@ -48,21 +48,7 @@ void AudioSystem::shutdown() {
     Mix_HaltChannel(-1);
     Mix_HaltMusic();
 
-    // Free loaded sounds
-    for (auto& pair : sounds_) {
-        if (pair.second) {
-            Mix_FreeChunk(pair.second);
-        }
-    }
-    sounds_.clear();
-
-    // Free loaded music
-    for (auto& pair : musicCache_) {
-        if (pair.second) {
-            Mix_FreeMusic(pair.second);
-        }
-    }
-    musicCache_.clear();
+    // Chunks and music are owned (and freed) by the AssetCache
 
     Mix_CloseAudio();
     Mix_Quit();
@@ -109,42 +95,18 @@ void AudioSystem::setMuted(bool muted) {
     setMasterVolume(masterVolume_);  // Trigger volume update
 }
 
+// Always go through the asset cache: it may evict idle chunks and music to
+// stay within its memory budget, so pointers must not be held between calls
 Mix_Chunk* AudioSystem::getChunk(const std::string& id) {
-    // Check cache
-    auto it = sounds_.find(id);
-    if (it != sounds_.end()) {
-        return it->second;
-    }
-
-    // Try to load from asset cache
-    if (assetCache_) {
-        Mix_Chunk* chunk = assetCache_->getSound(id);
-        if (chunk) {
-            sounds_[id] = chunk;
-            return chunk;
-        }
-    }
-
-    return nullptr;
+    return assetCache_ ? assetCache_->getSound(id) : nullptr;
 }
 
 Mix_Music* AudioSystem::getMusicHandle(const std::string& id) {
-    // Check cache
-    auto it = musicCache_.find(id);
-    if (it != musicCache_.end()) {
-        return it->second;
-    }
-
-    // Try to load from asset cache
-    if (assetCache_) {
-        Mix_Music* music = assetCache_->getMusic(id);
-        if (music) {
-            musicCache_[id] = music;
-            return music;
-        }
-    }
+    return assetCache_ ? assetCache_->getMusic(id) : nullptr;
+}
 
-    return nullptr;
+AssetHandle AudioSystem::resolveSound(const std::string& id) {
+    return assetCache_ ? assetCache_->resolve(id) : AssetHandle{};
 }
 
 int AudioSystem::playSound(const std::string& id, float volume) {
@@ -156,6 +118,15 @@ int AudioSystem::playSound(const std::string& id, float volume) {
     return playSound(chunk, volume);
 }
 
+int AudioSystem::playSound(AssetHandle sound, float volume) {
+    Mix_Chunk* chunk = assetCache_ ? assetCache_->getSound(sound) : nullptr;
+    if (!chunk) {
+        lastError_ = "Sound not found: " + (assetCache_ ? assetCache_->getAssetId(sound) : std::string());
+        return -1;
+    }
+    return playSound(chunk, volume);
+}
+
 int AudioSystem::playSound(Mix_Chunk* chunk, float volume) {
     if (!chunk || !initialized_) return -1;
 
@@ -192,7 +163,14 @@ int AudioSystem::playSoundLooped(const std::string& id, int loops, float volume)
 }
 
 int AudioSystem::playSoundAt(const std::string& id, int x, int y, float volume) {
-    Mix_Chunk* chunk = getChunk(id);
+    return playChunkAt(getChunk(id), x, y, volume);
+}
+
+int AudioSystem::playSoundAt(AssetHandle sound, int x, int y, float volume) {
+    return playChunkAt(assetCache_ ? assetCache_->getSound(sound) : nullptr, x, y, volume);
+}
+
+int AudioSystem::playChunkAt(Mix_Chunk* chunk, int x, int y, float volume) {
     if (!chunk || !initialized_) return -1;
 
     int channel = Mix_PlayChannel(-1, chunk, 0);
@@ -352,6 +330,29 @@ void AudioSystem::crossfadeMusic(const std::string& id, int fadeMs) {
     currentMusicId_ = id;
 }
 
+bool AudioSystem::hookStream(void (*callback)(void* userdata, uint8_t* stream, int bytes), void* userdata) {
+    if (!callback || !initialized_) return false;
+
+    // The hook takes the music stream's place
+    Mix_HaltMusic();
+    currentMusicId_.clear();
+    Mix_HookMusic(callback, userdata);
+    return true;
+}
+
+void AudioSystem::unhookStream() {
+    // Returns once the callback is no longer running
+    Mix_HookMusic(nullptr, nullptr);
+}
+
+bool AudioSystem::getOutputFormat(int& frequency, int& channels) const {
+    Uint16 format;
+    if (!initialized_ || Mix_QuerySpec(&frequency, &format, &channels) == 0) {
+        return false;
+    }
+    return true;
+}
+
 void AudioSystem::queueSound(const std::string& id) {
     soundQueue_.push_back(id);
 }
@@ -369,22 +370,14 @@ void AudioSystem::preloadMusic(const std::string& id) {
 }
 
 void AudioSystem::unloadSound(const std::string& id) {
-    auto it = sounds_.find(id);
-    if (it != sounds_.end()) {
-        if (it->second) {
-            Mix_FreeChunk(it->second);
-        }
-        sounds_.erase(it);
+    if (assetCache_) {
+        assetCache_->evict(AssetType::Sound, id);
     }
 }
 
 void AudioSystem::unloadMusic(const std::string& id) {
-    auto it = musicCache_.find(id);
-    if (it != musicCache_.end()) {
-        if (it->second) {
-            Mix_FreeMusic(it->second);
-        }
-        musicCache_.erase(it);
+    if (assetCache_) {
+        assetCache_->evict(AssetType::Music, id);
     }
 }
 
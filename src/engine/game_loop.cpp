@@ -199,6 +199,11 @@ void Game::processFrame() {
         return;
     }
 
+    // Create textures for assets decoded in the background, within budget
+    if (assetCache_) {
+        assetCache_->pumpUploads(config_.assetUploadBudgetMs);
+    }
+
 #ifdef _WIN32
     // Update asset viewer window if open
     if (assetViewer_ && assetViewer_->isOpen()) {
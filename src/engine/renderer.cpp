@@ -1,5 +1,6 @@
 #include "renderer.h"
 #include "grp_archive.h"
+#include "texture_atlas.h"
 #include <SDL.h>
 #include <algorithm>
 #include <cstring>
@@ -236,6 +237,11 @@ void Renderer::drawSprite(SDL_Texture* texture, const Rect& srcRect, const Rect&
     }
 }
 
+void Renderer::drawSprite(const AtlasRegion& region, int x, int y) {
+    drawSprite(region.texture, Rect(region.x, region.y, region.width, region.height),
+               Rect(x, y, region.width, region.height));
+}
+
 void Renderer::drawSpriteFlipped(SDL_Texture* texture, int x, int y, bool flipH, bool flipV) {
     if (!texture) return;
 
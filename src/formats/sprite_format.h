@@ -131,6 +131,8 @@ constexpr uint16_t RES_TYPE_AUDIO = 0xFF07;         // CUSTOM_32519 (WAV files)
 // Sprite decoder class
 class SpriteDecoder {
 public:
+    SpriteDecoder();
+
     // Load the 256-color game palette from AUTO256.BMP
     bool loadPalette(const std::string& gamePath);
 
@@ -143,12 +145,17 @@ public:
     // Decompress RLE-compressed sprite data
     // Format: FF <byte> <count> = repeat byte count times
     //         Other bytes = literal
+    // compileSpansEscapeFF() (span_sprite.h) compiles the same stream to
+    // opaque spans for drawing without the full-size buffer.
     static std::vector<uint8_t> decompressRLE(const uint8_t* data, size_t dataSize,
                                                size_t expectedPixels);
 
     // Convert palette-indexed data to RGBA pixels
     std::vector<uint32_t> convertToRGBA(const std::vector<uint8_t>& indexed);
 
+    // Same, into a caller buffer (e.g. a locked texture row) of count pixels
+    void convertToRGBA(const uint8_t* indexed, uint32_t* dst, size_t count) const;
+
     // Get palette entry
     void getPaletteColor(uint8_t index, uint8_t& r, uint8_t& g, uint8_t& b) const;
 
@@ -160,6 +167,7 @@ public:
 
 private:
     uint8_t palette_[256][4]; // BGRA format from BMP
+    uint32_t lut_[256];       // palette_ as 0xAARRGGBB, rebuilt on load
     bool paletteLoaded_ = false;
 };
 
@@ -25,6 +25,21 @@ void Player::init() {
     collectedParts_.clear();
 }
 
+void Player::setAudioSystem(AudioSystem* audio) {
+    audio_ = audio;
+    sounds_ = {};
+    if (audio_) {
+        sounds_.jump = audio_->resolveSound("player_jump");
+        sounds_.partCollect = audio_->resolveSound("part_collect");
+        sounds_.doorOpen = audio_->resolveSound("door_open");
+        sounds_.doorLocked = audio_->resolveSound("door_locked");
+        sounds_.puzzleComplete = audio_->resolveSound("puzzle_complete");
+        sounds_.hurt = audio_->resolveSound("player_hurt");
+        sounds_.gameOver = audio_->resolveSound("game_over");
+        sounds_.extraLife = audio_->resolveSound("extra_life");
+    }
+}
+
 void Player::handleInput(InputSystem* input) {
     if (!input) return;
 
@@ -235,7 +250,7 @@ void Player::jump() {
     state_ = PlayerState::Jumping;
 
     if (audio_) {
-        audio_->playSound("player_jump");
+        audio_->playSound(sounds_.jump);
     }
 }
 
@@ -346,7 +361,7 @@ void Player::onPartCollected(PartEntity* part) {
     collectPart(part->getPartType(), part->getCategory());
 
     if (audio_) {
-        audio_->playSound("part_collect");
+        audio_->playSound(sounds_.partCollect);
     }
 
     addScore(100);
@@ -357,7 +372,7 @@ void Player::onDoorEntered(DoorEntity* door) {
     door->open();
 
     if (audio_) {
-        audio_->playSound("door_open");
+        audio_->playSound(sounds_.doorOpen);
     }
 }
 
@@ -540,7 +555,7 @@ void Player::exitPuzzle(bool success) {
     if (success) {
         addScore(500);
         if (audio_) {
-            audio_->playSound("puzzle_complete");
+            audio_->playSound(sounds_.puzzleComplete);
         }
     }
 
@@ -557,13 +572,13 @@ void Player::loseLife() {
     velX_ = (direction_ == Direction::Right) ? -100.0f : 100.0f;
 
     if (audio_) {
-        audio_->playSound("player_hurt");
+        audio_->playSound(sounds_.hurt);
     }
 
     if (lives_ <= 0) {
         state_ = PlayerState::Dead;
         if (audio_) {
-            audio_->playSound("game_over");
+            audio_->playSound(sounds_.gameOver);
         }
     }
 }
@@ -572,7 +587,7 @@ void Player::gainLife() {
     lives_++;
 
     if (audio_) {
-        audio_->playSound("extra_life");
+        audio_->playSound(sounds_.extraLife);
     }
 }
 
@@ -599,7 +614,7 @@ void Player::interact() {
         if (!door->isLocked()) {
             door->open();
         } else if (audio_) {
-            audio_->playSound("door_locked");
+            audio_->playSound(sounds_.doorLocked);
         }
     }
 
@@ -69,7 +69,7 @@ void Puzzle::complete(PuzzleResult result) {
     }
 }
 
-void Puzzle::playSound(const std::string& sound) {
+void Puzzle::playSound(AssetHandle sound) {
     if (audio_) {
         audio_->playSound(sound);
     }
@@ -83,6 +83,11 @@ BalancePuzzle::BalancePuzzle() {
 bool BalancePuzzle::init(int difficulty, AssetCache* assetCache) {
     Puzzle::init(difficulty, assetCache);
 
+    if (assetCache) {
+        clickSound_ = assetCache->resolve("click");
+        placeSound_ = assetCache->resolve("weight_place");
+    }
+
     // Generate weights based on difficulty
     int numWeights = 4 + difficulty * 2;
     weights_.clear();
@@ -224,7 +229,7 @@ void BalancePuzzle::handleInput(InputSystem* input) {
 
             if (mx >= wx && mx < wx + 30 && my >= wy && my < wy + 30) {
                 selectedWeight_ = static_cast<int>(i);
-                playSound("click");
+                playSound(clickSound_);
                 break;
             }
         }
@@ -239,7 +244,7 @@ void BalancePuzzle::handleInput(InputSystem* input) {
             } else {
                 weights_[selectedWeight_].side = 1;  // Right
             }
-            playSound("weight_place");
+            playSound(placeSound_);
             selectedWeight_ = -1;
         }
     }
@@ -253,6 +258,11 @@ GearPuzzle::GearPuzzle() {
 bool GearPuzzle::init(int difficulty, AssetCache* assetCache) {
     Puzzle::init(difficulty, assetCache);
 
+    if (assetCache) {
+        clickSound_ = assetCache->resolve("gear_click");
+        placeSound_ = assetCache->resolve("gear_place");
+    }
+
     // Create slots for gears
     slots_.clear();
     int numSlots = 4 + difficulty;
@@ -395,7 +405,7 @@ void GearPuzzle::handleInput(InputSystem* input) {
             float dy = my - g.y;
             if (dx * dx + dy * dy < g.radius * g.radius) {
                 selectedGear_ = static_cast<int>(i);
-                playSound("gear_click");
+                playSound(clickSound_);
                 break;
             }
         }
@@ -422,7 +432,7 @@ void GearPuzzle::placeGear(int gearIndex, int slotIndex) {
     gear.y = slots_[slotIndex].second;
     gear.connected = true;  // Simplified - would check actual connections
     gear.speed = 80.0f;     // Would calculate based on gear ratios
-    playSound("gear_place");
+    playSound(placeSound_);
 }
 
 // Puzzle Factory
@@ -1,12 +1,24 @@
 #include "asset_cache.h"
 #include "ne_resource.h"
 #include "grp_archive.h"
+#include "resource_catalog.h"
+#include "crc32.h"
+#include "cache_pack.h"
+#include "directory_index.h"
+#include "job_pool.h"
+#include "palette.h"
+#include "mapped_file.h"
+#include "sprite_index.h"
 #include <fstream>
 #include <sstream>
 #include <filesystem>
 #include <algorithm>
 #include <cstring>
-#include <regex>
+#include <chrono>
+#include <ctime>
+#include <limits>
+#include <string_view>
+#include <cstdio>
 
 #ifdef SDL_h_
 #include <SDL.h>
@@ -17,33 +29,247 @@ namespace fs = std::filesystem;
 
 namespace opengg {
 
-// CRC32 lookup table
-static uint32_t crc32Table[256];
-static bool crc32TableInit = false;
+// Game subdirectories that hold NE resource files, in lookup priority order
+// ("" is the game root itself)
+static const std::vector<std::string> kResourceDirs = {
+    "SSGWINCD",         // Gizmos & Gadgets
+    "ONWINCD",          // Operation Neptune (alternate)
+    "ONWINCD/INSTALL",  // Neptune install dir
+    "sso_extract",      // OutNumbered
+    "ssr_extract",      // Spellbound
+    "tms_extract",      // Treasure MathStorm
+    "iso/SSGWINCD",     // ISO mount paths
+    "iso/INSTALL",
+    ""                  // Root fallback
+};
+
+// Directories scanned for the resource catalog (NE dirs plus GRP archives)
+static std::vector<std::string> catalogDirs() {
+    std::vector<std::string> dirs = kResourceDirs;
+    dirs.insert(dirs.end() - 1, "ASSETS");
+    return dirs;
+}
+
+// Prepend a BITMAPFILEHEADER to an NE bitmap resource (a bare BITMAPINFO)
+static void wrapBitmapResource(std::vector<uint8_t>& data) {
+    if (data.size() <= 40) {
+        return;
+    }
+
+    std::vector<uint8_t> bmp;
+    bmp.reserve(14 + data.size());
+
+    // BMP file header
+    uint32_t fileSize = 14 + static_cast<uint32_t>(data.size());
+    uint32_t headerSize = *reinterpret_cast<uint32_t*>(data.data());
+    uint16_t bitCount = *reinterpret_cast<uint16_t*>(data.data() + 14);
+    uint32_t paletteSize = (bitCount <= 8) ? (1u << bitCount) * 4 : 0;
+    uint32_t dataOffset = 14 + headerSize + paletteSize;
+
+    bmp.push_back('B');
+    bmp.push_back('M');
+    bmp.insert(bmp.end(), reinterpret_cast<uint8_t*>(&fileSize),
+               reinterpret_cast<uint8_t*>(&fileSize) + 4);
+    bmp.push_back(0); bmp.push_back(0);  // Reserved
+    bmp.push_back(0); bmp.push_back(0);  // Reserved
+    bmp.insert(bmp.end(), reinterpret_cast<uint8_t*>(&dataOffset),
+               reinterpret_cast<uint8_t*>(&dataOffset) + 4);
+    bmp.insert(bmp.end(), data.begin(), data.end());
+
+    data = std::move(bmp);
+}
+
+#ifdef SDL_h_
+// Expand a parsed bitmap straight into a locked ARGB8888 texture
+static SDL_Texture* createBitmapTexture(SDL_Renderer* renderer, const BitmapView& bitmap,
+                                        std::string& error, LoadTiming* timing) {
+    StageTimer uploadTimer(timing, LoadStage::Upload);
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                             SDL_TEXTUREACCESS_STREAMING, bitmap.width, bitmap.height);
+    if (!texture) {
+        error = "Failed to create texture: " + std::string(SDL_GetError());
+        return nullptr;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    void* pixels;
+    int pitch;
+    if (SDL_LockTexture(texture, nullptr, &pixels, &pitch) != 0) {
+        error = "Failed to lock texture: " + std::string(SDL_GetError());
+        SDL_DestroyTexture(texture);
+        return nullptr;
+    }
+    uploadTimer.stop();
+
+    StageTimer convertTimer(timing, LoadStage::Convert);
+    expandBitmap(bitmap, static_cast<uint8_t*>(pixels), static_cast<size_t>(pitch));
+    convertTimer.stop();
+
+    StageTimer unlockTimer(timing, LoadStage::Upload);
+    SDL_UnlockTexture(texture);
+    return texture;
+}
+
+// Upload ARGB8888 rows expanded on a worker thread in one copy
+static SDL_Texture* createPixelTexture(SDL_Renderer* renderer, const std::vector<uint32_t>& pixels,
+                                       int width, int height) {
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                             SDL_TEXTUREACCESS_STATIC, width, height);
+    if (!texture) {
+        return nullptr;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    if (SDL_UpdateTexture(texture, nullptr, pixels.data(), width * 4) != 0) {
+        SDL_DestroyTexture(texture);
+        return nullptr;
+    }
+    return texture;
+}
+#endif
+
+// Approximate memory held by each kind of cached asset
+static size_t textureBytes(const CachedTexture& ct) {
+    return static_cast<size_t>(ct.width) * ct.height * 4;
+}
+
+static size_t spriteBytes(const Sprite& sprite) {
+    return sizeof(Sprite) + sprite.pixels.size() + sprite.palette.size() * sizeof(uint32_t);
+}
 
-static void initCRC32Table() {
-    if (crc32TableInit) return;
-    for (uint32_t i = 0; i < 256; ++i) {
-        uint32_t crc = i;
-        for (int j = 0; j < 8; ++j) {
-            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+static size_t fileBytes(const std::string& path) {
+    std::error_code ec;
+    auto size = fs::file_size(path, ec);
+    return ec ? 0 : static_cast<size_t>(size);
+}
+
+static int64_t fileModifiedTime(const std::string& path) {
+    std::error_code ec;
+    auto time = fs::last_write_time(path, ec);
+    return ec ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+// NE resource type for the type part of a legacy asset ID
+static uint16_t neResourceType(const std::string& type) {
+    if (type == "bitmap") {
+        return NE_RT_BITMAP;
+    } else if (type == "font") {
+        return NE_RT_FONT;
+    }
+    return NE_RT_RCDATA;
+}
+
+// Glob match: '*' matches any run of characters, '?' any single one
+static bool globMatch(std::string_view pattern, std::string_view text) {
+    size_t p = 0, t = 0;
+    size_t starP = std::string_view::npos, starT = 0;
+
+    while (t < text.size()) {
+        if (p < pattern.size() && pattern[p] == '*') {
+            starP = p++;
+            starT = t;
+        } else if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+            p++;
+            t++;
+        } else if (starP != std::string_view::npos) {
+            // Let the last '*' absorb one more character and retry
+            p = starP + 1;
+            t = ++starT;
+        } else {
+            return false;
+        }
+    }
+
+    while (p < pattern.size() && pattern[p] == '*') {
+        p++;
+    }
+    return p == pattern.size();
+}
+
+// Identity of an asset's source data, for sharing one loaded copy between
+// asset IDs: CRC in the high half, size in the low half (0 = nothing)
+static uint64_t contentKey(const uint8_t* data, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    return (static_cast<uint64_t>(crc32(data, size)) << 32) | static_cast<uint32_t>(size);
+}
+
+// Loads kept in Stats::slowestLoads
+static constexpr size_t SLOW_LOAD_COUNT = 10;
+
+// Entries in Stats::loads
+static constexpr size_t ASSET_TYPE_COUNT = 5;
+
+static const char* assetTypeName(AssetType type) {
+    switch (type) {
+        case AssetType::Texture: return "texture";
+        case AssetType::Sprite:  return "sprite";
+        case AssetType::Sound:   return "sound";
+        case AssetType::Music:   return "music";
+        case AssetType::Data:    return "data";
+    }
+    return "unknown";
+}
+
+static void writeJsonString(std::ostream& out, const std::string& str) {
+    out << '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out << escaped;
+        } else {
+            out << c;
         }
-        crc32Table[i] = crc;
     }
-    crc32TableInit = true;
+    out << '"';
 }
 
-AssetCache::AssetCache() {
-    initCRC32Table();
+static void writeHistogramJson(std::ostream& out, const LatencyHistogram& histogram) {
+    out << "{\"count\": " << histogram.getCount()
+        << ", \"totalMs\": " << histogram.getTotalMs()
+        << ", \"p50\": " << histogram.getPercentile(0.50)
+        << ", \"p95\": " << histogram.getPercentile(0.95)
+        << ", \"p99\": " << histogram.getPercentile(0.99)
+        << ", \"max\": " << histogram.getMaxMs() << "}";
+}
+
+static constexpr char CACHE_INDEX_MAGIC[4] = {'O', 'G', 'C', 'M'};
+static constexpr uint32_t CACHE_INDEX_VERSION = 1;
+
+AssetCache::AssetCache()
+    : catalog_(std::make_unique<ResourceCatalog>()),
+      dirIndex_(std::make_unique<DirectoryIndex>()),
+      pack_(std::make_unique<CachePack>()) {
 }
 
 AssetCache::~AssetCache() {
+    // Stop the workers and the catalog load before tearing down what they read
+    loadPool_.reset();
+    waitForCatalog();
     clearCache();
+
+    if (cacheIndexDirty_) {
+        saveCacheIndex();
+    }
 }
 
 bool AssetCache::initialize(const std::string& gamePath, const std::string& cachePath) {
+    // Requests in flight belong to the previous game
+    cancelRequests("Asset cache reinitialized");
+
+    if (cacheIndexDirty_) {
+        saveCacheIndex();
+    }
+
+    // The catalog thread reads the paths about to change
+    waitForCatalog();
+
     gamePath_ = gamePath;
     cachePath_ = cachePath;
+    dirIndex_->refresh();
 
     // Create cache directory if it doesn't exist
     try {
@@ -53,28 +279,158 @@ bool AssetCache::initialize(const std::string& gamePath, const std::string& cach
         return false;
     }
 
-    // Load cache index
-    loadCacheIndex();
+    // Open the disk cache (a failure only means assets are re-extracted)
+    openCachePack();
+
+    // Loading (or on a first run, building) the catalog means hashing every
+    // game file, so it happens off the main thread; lookups wait only if
+    // they come before it is ready
+    catalogReady_ = std::async(std::launch::async, [this]() { loadCatalog(); }).share();
+
+    // Drop cached assets whose source files changed
+    validateCache();
 
     return true;
 }
 
+const ResourceCatalog& AssetCache::catalog() const {
+    waitForCatalog();
+    return *catalog_;
+}
+
+void AssetCache::waitForCatalog() const {
+    if (catalogReady_.valid()) {
+        catalogReady_.wait();
+    }
+}
+
+void AssetCache::loadCatalog() {
+    std::string catalogPath = cachePath_ + "/resource_catalog.dat";
+    if (catalog_->load(catalogPath) && !catalog_->isStale(gamePath_)) {
+        return;
+    }
+
+    // Lookups fall back to opening the files directly if this fails
+    if (catalog_->build(gamePath_, catalogDirs())) {
+        catalog_->save(catalogPath);
+    }
+}
+
+bool AssetCache::rebuildCatalog() {
+    // Workers read the catalog while decoding
+    waitForDecodes();
+    waitForCatalog();
+    dirIndex_->refresh();
+
+    if (!catalog_->build(gamePath_, catalogDirs())) {
+        lastError_ = catalog_->getLastError();
+        return false;
+    }
+    return catalog_->save(cachePath_ + "/resource_catalog.dat");
+}
+
+void AssetCache::refreshDirectoryIndex() {
+    dirIndex_->refresh();
+}
+
+std::string AssetCache::findGameFile(const std::string& filename) const {
+    for (const auto& dir : kResourceDirs) {
+        std::string path = dirIndex_->find(dir.empty() ? gamePath_ : gamePath_ + "/" + dir, filename);
+        if (!path.empty()) {
+            return path;
+        }
+    }
+    return {};
+}
+
+std::string AssetCache::findInGameDirs(std::initializer_list<const char*> dirs,
+                                       const std::string& filename) const {
+    for (const char* dir : dirs) {
+        std::string path = dirIndex_->find(*dir ? gamePath_ + "/" + dir : gamePath_, filename);
+        if (!path.empty()) {
+            return path;
+        }
+    }
+    return {};
+}
+
 void AssetCache::setRenderer(SDL_Renderer* renderer) {
     renderer_ = renderer;
 }
 
 bool AssetCache::validateCache() {
-    // Check if original game files have changed
-    // For now, just check if cache index exists
-    std::string indexPath = cachePath_ + "/cache_index.dat";
-    return fs::exists(indexPath);
+    if (!pack_->isOpen()) {
+        return false;
+    }
+
+    size_t dropped = 0;
+
+    // Blobs without a metadata record (e.g. after a crash) can't be checked
+    std::unordered_set<std::string> cached;
+    for (const auto& info : pack_->list()) {
+        if (cacheIndex_.count(info.id)) {
+            cached.insert(info.id);
+        } else {
+            pack_->remove(info.id);
+            dropped++;
+        }
+    }
+
+    // Stat each source file once; if its size and timestamp still match,
+    // its assets are valid without reading anything
+    std::unordered_map<std::string, std::pair<uint64_t, int64_t>> sources;
+
+    for (auto it = cacheIndex_.begin(); it != cacheIndex_.end();) {
+        AssetMeta& meta = it->second;
+        if (!cached.count(meta.id)) {
+            it = cacheIndex_.erase(it);
+            cacheIndexDirty_ = true;
+            continue;
+        }
+
+        auto source = sources.find(meta.sourcePath);
+        if (source == sources.end()) {
+            source = sources.emplace(meta.sourcePath,
+                std::make_pair(static_cast<uint64_t>(fileBytes(meta.sourcePath)),
+                               fileModifiedTime(meta.sourcePath))).first;
+        }
+        if (source->second.first == meta.sourceSize && source->second.second == meta.sourceModified) {
+            ++it;
+            continue;
+        }
+
+        // The source changed: keep the entry only if the asset itself didn't
+        std::vector<uint8_t> data;
+        if (extractAsset(meta.id, data) && calculateCRC32(data) == meta.crc32) {
+            meta.sourcePath = findSourceFile(meta.id, meta.sourceOffset);
+            meta.sourceSize = fileBytes(meta.sourcePath);
+            meta.sourceModified = fileModifiedTime(meta.sourcePath);
+            cacheIndexDirty_ = true;
+            ++it;
+            continue;
+        }
+
+        pack_->remove(meta.id);
+        it = cacheIndex_.erase(it);
+        cacheIndexDirty_ = true;
+        dropped++;
+    }
+
+    if (cacheIndexDirty_) {
+        saveCacheIndex();
+    }
+    pack_->commit();
+
+    return dropped == 0;
 }
 
 void AssetCache::clearCache() {
+    cancelRequests("Asset cache cleared");
+
 #ifdef SDL_h_
-    // Free textures
+    // Free textures (shared ones once)
     for (auto& pair : textures_) {
-        if (pair.second.texture) {
+        if (pair.second.texture && releaseShared(AssetType::Texture, pair.first)) {
             SDL_DestroyTexture(pair.second.texture);
         }
     }
@@ -82,7 +438,7 @@ void AssetCache::clearCache() {
 
     // Free sounds
     for (auto& pair : sounds_) {
-        if (pair.second) {
+        if (pair.second && releaseShared(AssetType::Sound, pair.first)) {
             Mix_FreeChunk(pair.second);
         }
     }
@@ -98,10 +454,23 @@ void AssetCache::clearCache() {
 #endif
 
     sprites_.clear();
+    atlases_.clear();
+    for (size_t i = 0; i < 4; ++i) {
+        shared_[i].clear();
+        contentKeys_[i].clear();
+    }
     neFiles_.clear();
     grpFiles_.clear();
-    cacheIndex_.clear();
+    for (auto& lru : lru_) {
+        lru = LRUList();
+    }
+    evictedAssets_.clear();
     stats_ = {};
+
+    // Handles stay valid; their assets reload on next use
+    for (auto& slot : handles_) {
+        slot = HandleSlot{std::move(slot.assetId)};
+    }
 }
 
 SDL_Texture* AssetCache::getTexture(const std::string& assetId) {
@@ -115,11 +484,13 @@ SDL_Texture* AssetCache::getTexture(const std::string& assetId) {
     auto it = textures_.find(assetId);
     if (it != textures_.end()) {
         it->second.refCount++;
+        touchAsset(AssetType::Texture, assetId);
         stats_.cacheHits++;
         return it->second.texture;
     }
 
     stats_.cacheMisses++;
+    LoadTiming timing;
 
     // Parse asset ID
     std::string source, type;
@@ -130,38 +501,37 @@ SDL_Texture* AssetCache::getTexture(const std::string& assetId) {
     }
 
     // Try to load from disk cache first
-    auto cached = loadFromCache(assetId);
+    auto cached = loadFromCache(assetId, &timing);
     if (!cached.empty()) {
-        // Create texture from cached BMP/PNG data
-        SDL_RWops* rw = SDL_RWFromMem(cached.data(), static_cast<int>(cached.size()));
-        if (rw) {
-            SDL_Surface* surface = SDL_LoadBMP_RW(rw, 1);
-            if (surface) {
-                SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer_, surface);
-                if (texture) {
-                    CachedTexture ct;
-                    ct.texture = texture;
-                    ct.width = surface->w;
-                    ct.height = surface->h;
-                    ct.refCount = 1;
-                    textures_[assetId] = ct;
-                    SDL_FreeSurface(surface);
-                    stats_.texturesLoaded++;
-                    return texture;
-                }
-                SDL_FreeSurface(surface);
-            }
+        uint64_t content = contentKey(cached.data(), cached.size());
+        if (SDL_Texture* shared = useSharedTexture(assetId, content, 1)) {
+            recordLoad(AssetType::Texture, assetId, timing);
+            return shared;
+        }
+
+        // Create texture from cached BMP data
+        CachedTexture ct;
+        ct.texture = createTextureFromBMP(cached.data(), cached.size(), ct.width, ct.height, &timing);
+        if (ct.texture) {
+            ct.refCount = 1;
+            textures_[assetId] = ct;
+            addShared(AssetType::Texture, assetId, content,
+                      {ct.texture, ct.width, ct.height, textureBytes(ct)});
+            trackAsset(AssetType::Texture, assetId, textureBytes(ct));
+            stats_.texturesLoaded++;
+            recordLoad(AssetType::Texture, assetId, timing);
+            return ct.texture;
         }
     }
 
     // Load from original game files
     std::vector<uint8_t> data;
     if (type == "bitmap") {
-        if (!loadFromNE(source, type, id, data)) {
+        if (!loadFromNE(source, type, id, data, &timing)) {
             return nullptr;
         }
     } else if (type == "sprite") {
-        if (!loadFromGrp(source, std::to_string(id), data)) {
+        if (!loadFromGrp(source, std::to_string(id), data, &timing)) {
             return nullptr;
         }
     }
@@ -171,39 +541,33 @@ SDL_Texture* AssetCache::getTexture(const std::string& assetId) {
         return nullptr;
     }
 
-    // Parse as bitmap
-    SDL_RWops* rw = SDL_RWFromMem(data.data(), static_cast<int>(data.size()));
-    if (!rw) {
-        lastError_ = "Failed to create RWops";
-        return nullptr;
-    }
-
-    SDL_Surface* surface = SDL_LoadBMP_RW(rw, 1);
-    if (!surface) {
-        lastError_ = "Failed to load BMP: " + std::string(SDL_GetError());
-        return nullptr;
+    // Same bytes as an asset already loaded under another ID
+    uint64_t content = contentKey(data.data(), data.size());
+    if (SDL_Texture* shared = useSharedTexture(assetId, content, 1)) {
+        saveToCache(assetId, data, AssetType::Texture);
+        recordLoad(AssetType::Texture, assetId, timing);
+        return shared;
     }
 
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer_, surface);
-    if (!texture) {
-        lastError_ = "Failed to create texture: " + std::string(SDL_GetError());
-        SDL_FreeSurface(surface);
+    // Parse as bitmap
+    CachedTexture ct;
+    ct.texture = createTextureFromBMP(data.data(), data.size(), ct.width, ct.height, &timing);
+    if (!ct.texture) {
         return nullptr;
     }
+    SDL_Texture* texture = ct.texture;
 
     // Cache in memory
-    CachedTexture ct;
-    ct.texture = texture;
-    ct.width = surface->w;
-    ct.height = surface->h;
     ct.refCount = 1;
     textures_[assetId] = ct;
+    addShared(AssetType::Texture, assetId, content, {texture, ct.width, ct.height, textureBytes(ct)});
+    trackAsset(AssetType::Texture, assetId, textureBytes(ct));
 
     // Save to disk cache
-    saveToCache(assetId, data);
+    saveToCache(assetId, data, AssetType::Texture);
 
-    SDL_FreeSurface(surface);
     stats_.texturesLoaded++;
+    recordLoad(AssetType::Texture, assetId, timing);
 
     return texture;
 #else
@@ -216,11 +580,13 @@ std::shared_ptr<Sprite> AssetCache::getSprite(const std::string& assetId) {
     // Check if already loaded
     auto it = sprites_.find(assetId);
     if (it != sprites_.end()) {
+        touchAsset(AssetType::Sprite, assetId);
         stats_.cacheHits++;
         return it->second;
     }
 
     stats_.cacheMisses++;
+    LoadTiming timing;
 
     // Parse asset ID to get GRP file and sprite name
     std::string source, type;
@@ -233,6 +599,7 @@ std::shared_ptr<Sprite> AssetCache::getSprite(const std::string& assetId) {
             std::string name = assetId.substr(colonPos + 1);
 
             // Get or open GRP archive
+            StageTimer resolveTimer(&timing, LoadStage::Resolve);
             auto grpIt = grpFiles_.find(source);
             if (grpIt == grpFiles_.end()) {
                 auto grp = std::make_unique<GrpArchive>();
@@ -244,11 +611,17 @@ std::shared_ptr<Sprite> AssetCache::getSprite(const std::string& assetId) {
                 grpFiles_[source] = std::move(grp);
                 grpIt = grpFiles_.find(source);
             }
+            resolveTimer.stop();
 
+            // Reads, decompresses and decodes in one go
+            StageTimer convertTimer(&timing, LoadStage::Convert);
             auto sprite = grpIt->second->extractSprite(name);
+            convertTimer.stop();
             if (sprite) {
                 auto shared = std::make_shared<Sprite>(std::move(*sprite));
                 sprites_[assetId] = shared;
+                trackAsset(AssetType::Sprite, assetId, spriteBytes(*shared));
+                recordLoad(AssetType::Sprite, assetId, timing);
                 return shared;
             }
         }
@@ -259,18 +632,49 @@ std::shared_ptr<Sprite> AssetCache::getSprite(const std::string& assetId) {
     return nullptr;
 }
 
+const SpriteIndex* AssetCache::getSpriteIndex(const std::string& source) {
+    auto it = spriteIndexes_.find(source);
+    if (it != spriteIndexes_.end()) {
+        return it->second.get();
+    }
+
+    std::string datPath = findGameFile(source + ".DAT");
+    if (datPath.empty()) {
+        lastError_ = "Game file not found: " + source + ".DAT";
+        return nullptr;
+    }
+
+    // Parsing the sprite tables means measuring every frame, so the result
+    // is kept in the cache dir until the DAT file changes
+    auto index = std::make_unique<SpriteIndex>();
+    std::string indexPath = cachePath_ + "/sprite_index_" + source + ".dat";
+    if (!index->load(indexPath, datPath)) {
+        if (!index->build(datPath)) {
+            lastError_ = index->getLastError();
+            return nullptr;
+        }
+        index->save(indexPath);
+    }
+
+    const SpriteIndex* result = index.get();
+    spriteIndexes_[source] = std::move(index);
+    return result;
+}
+
 Mix_Chunk* AssetCache::getSound(const std::string& assetId) {
 #ifdef SDL_h_
     auto it = sounds_.find(assetId);
     if (it != sounds_.end()) {
+        touchAsset(AssetType::Sound, assetId);
         stats_.cacheHits++;
         return it->second;
     }
 
     stats_.cacheMisses++;
+    LoadTiming timing;
 
     // Load from cache or extract
-    auto cached = loadFromCache(assetId);
+    auto cached = loadFromCache(assetId, &timing);
     if (cached.empty()) {
         // Extract from original files
         std::string source, type;
@@ -280,11 +684,17 @@ Mix_Chunk* AssetCache::getSound(const std::string& assetId) {
             return nullptr;
         }
 
-        if (!loadFromNE(source, type, id, cached)) {
+        if (!loadFromNE(source, type, id, cached, &timing)) {
             return nullptr;
         }
 
-        saveToCache(assetId, cached);
+        saveToCache(assetId, cached, AssetType::Sound);
+    }
+
+    uint64_t content = contentKey(cached.data(), cached.size());
+    if (Mix_Chunk* shared = useSharedSound(assetId, content)) {
+        recordLoad(AssetType::Sound, assetId, timing);
+        return shared;
     }
 
     SDL_RWops* rw = SDL_RWFromMem(cached.data(), static_cast<int>(cached.size()));
@@ -292,10 +702,15 @@ Mix_Chunk* AssetCache::getSound(const std::string& assetId) {
         return nullptr;
     }
 
+    StageTimer convertTimer(&timing, LoadStage::Convert);
     Mix_Chunk* chunk = Mix_LoadWAV_RW(rw, 1);
+    convertTimer.stop();
     if (chunk) {
         sounds_[assetId] = chunk;
+        addShared(AssetType::Sound, assetId, content, {chunk, 0, 0, chunk->alen});
+        trackAsset(AssetType::Sound, assetId, chunk->alen);
         stats_.soundsLoaded++;
+        recordLoad(AssetType::Sound, assetId, timing);
     }
 
     return chunk;
@@ -309,21 +724,34 @@ Mix_Music* AssetCache::getMusic(const std::string& assetId) {
 #ifdef SDL_h_
     auto it = music_.find(assetId);
     if (it != music_.end()) {
+        touchAsset(AssetType::Music, assetId);
         stats_.cacheHits++;
         return it->second;
     }
 
     stats_.cacheMisses++;
 
+    LoadTiming timing;
+
     // For MIDI, load directly from game path
-    std::string midiPath = gamePath_ + "/SSGWINCD/MIDI/" + assetId + ".MID";
-    if (!fs::exists(midiPath)) {
-        midiPath = gamePath_ + "/MIDI/" + assetId + ".MID";
+    StageTimer resolveTimer(&timing, LoadStage::Resolve);
+    std::string midiPath = findInGameDirs({"SSGWINCD/MIDI", "MIDI"}, assetId + ".MID");
+    resolveTimer.stop();
+    if (midiPath.empty()) {
+        lastError_ = "MIDI file not found: " + assetId + ".MID";
+        return nullptr;
     }
 
+    // SDL_mixer reads and parses the file in one call
+    StageTimer readTimer(&timing, LoadStage::Read);
     Mix_Music* mus = Mix_LoadMUS(midiPath.c_str());
+    readTimer.stop();
     if (mus) {
+        size_t bytes = fileBytes(midiPath);
         music_[assetId] = mus;
+        trackAsset(AssetType::Music, assetId, bytes);
+        timing.bytesFromDisk = bytes;
+        recordLoad(AssetType::Music, assetId, timing);
     } else {
         lastError_ = "Failed to load music: " + std::string(Mix_GetError());
     }
@@ -336,78 +764,992 @@ Mix_Music* AssetCache::getMusic(const std::string& assetId) {
 }
 
 std::vector<uint8_t> AssetCache::getData(const std::string& assetId) {
+    LoadTiming timing;
+
     // Try cache first
-    auto cached = loadFromCache(assetId);
+    auto cached = loadFromCache(assetId, &timing);
     if (!cached.empty()) {
         stats_.cacheHits++;
+        recordLoad(AssetType::Data, assetId, timing);
         return cached;
     }
 
-    stats_.cacheMisses++;
+    stats_.cacheMisses++;
+
+    std::string source, type;
+    int id;
+    if (!parseAssetId(assetId, source, type, id)) {
+        lastError_ = "Invalid asset ID: " + assetId;
+        return {};
+    }
+
+    std::vector<uint8_t> data;
+    if (!loadFromNE(source, type, id, data, &timing)) {
+        return {};
+    }
+
+    saveToCache(assetId, data, AssetType::Data);
+    recordLoad(AssetType::Data, assetId, timing);
+    return data;
+}
+
+void AssetCache::releaseTexture(const std::string& assetId) {
+    auto it = textures_.find(assetId);
+    if (it != textures_.end() && it->second.refCount > 0) {
+        it->second.refCount--;
+        // Kept cached; freed only when textures go over budget
+        if (it->second.refCount == 0) {
+            enforceBudget(AssetType::Texture);
+        }
+    }
+}
+
+// === Asset handles ===
+
+AssetHandle AssetCache::resolve(const std::string& assetId) {
+    if (handles_.empty()) {
+        handles_.emplace_back();    // Index 0 is the invalid handle
+    }
+
+    auto it = handleIndex_.find(assetId);
+    if (it != handleIndex_.end()) {
+        return AssetHandle{it->second};
+    }
+
+    uint32_t index = static_cast<uint32_t>(handles_.size());
+    handles_.push_back(HandleSlot{assetId});
+    handleIndex_[assetId] = index;
+
+    // Pick up anything already loaded under this ID
+    bindHandle(handles_[index], AssetType::Texture);
+    bindHandle(handles_[index], AssetType::Sound);
+    bindHandle(handles_[index], AssetType::Music);
+    return AssetHandle{index};
+}
+
+const std::string& AssetCache::getAssetId(AssetHandle handle) const {
+    static const std::string empty;
+    if (!handle.isValid() || handle.index >= handles_.size()) {
+        return empty;
+    }
+    return handles_[handle.index].assetId;
+}
+
+SDL_Texture* AssetCache::getTexture(AssetHandle handle) {
+    if (!handle.isValid() || handle.index >= handles_.size()) {
+        lastError_ = "Invalid asset handle";
+        return nullptr;
+    }
+
+    HandleSlot& slot = handles_[handle.index];
+    if (slot.texture) {
+        slot.texture->refCount++;
+        touchHandle(slot, AssetType::Texture);
+        stats_.cacheHits++;
+        return slot.texture->texture;
+    }
+
+    // Not loaded (or evicted); loading binds the slot
+    return getTexture(slot.assetId);
+}
+
+Mix_Chunk* AssetCache::getSound(AssetHandle handle) {
+    if (!handle.isValid() || handle.index >= handles_.size()) {
+        lastError_ = "Invalid asset handle";
+        return nullptr;
+    }
+
+    HandleSlot& slot = handles_[handle.index];
+    if (slot.sound) {
+        touchHandle(slot, AssetType::Sound);
+        stats_.cacheHits++;
+        return slot.sound;
+    }
+    return getSound(slot.assetId);
+}
+
+Mix_Music* AssetCache::getMusic(AssetHandle handle) {
+    if (!handle.isValid() || handle.index >= handles_.size()) {
+        lastError_ = "Invalid asset handle";
+        return nullptr;
+    }
+
+    HandleSlot& slot = handles_[handle.index];
+    if (slot.music) {
+        touchHandle(slot, AssetType::Music);
+        stats_.cacheHits++;
+        return slot.music;
+    }
+    return getMusic(slot.assetId);
+}
+
+void AssetCache::releaseTexture(AssetHandle handle) {
+    if (!handle.isValid() || handle.index >= handles_.size()) {
+        return;
+    }
+
+    CachedTexture* ct = handles_[handle.index].texture;
+    if (ct && ct->refCount > 0) {
+        ct->refCount--;
+        if (ct->refCount == 0) {
+            enforceBudget(AssetType::Texture);
+        }
+    }
+}
+
+AssetCache::HandleSlot* AssetCache::findHandle(const std::string& assetId) {
+    auto it = handleIndex_.find(assetId);
+    return it != handleIndex_.end() ? &handles_[it->second] : nullptr;
+}
+
+void AssetCache::bindHandle(HandleSlot& slot, AssetType type) {
+    LRUList& lru = lru_[static_cast<size_t>(type)];
+    auto entry = lru.entries.find(slot.assetId);
+    slot.lru[static_cast<size_t>(type)] = entry != lru.entries.end() ? &entry->second : nullptr;
+
+    switch (type) {
+        case AssetType::Texture: {
+            auto it = textures_.find(slot.assetId);
+            slot.texture = it != textures_.end() ? &it->second : nullptr;
+            break;
+        }
+        case AssetType::Sound: {
+            auto it = sounds_.find(slot.assetId);
+            slot.sound = it != sounds_.end() ? it->second : nullptr;
+            break;
+        }
+        case AssetType::Music: {
+            auto it = music_.find(slot.assetId);
+            slot.music = it != music_.end() ? it->second : nullptr;
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void AssetCache::updateHandle(AssetType type, const std::string& assetId) {
+    if (HandleSlot* slot = findHandle(assetId)) {
+        bindHandle(*slot, type);
+    }
+}
+
+void AssetCache::touchHandle(HandleSlot& slot, AssetType type) {
+    LRUList& lru = lru_[static_cast<size_t>(type)];
+    if (LRUEntry* entry = slot.lru[static_cast<size_t>(type)]) {
+        lru.order.splice(lru.order.begin(), lru.order, entry->position);
+    }
+}
+
+// === Shared payloads ===
+
+SDL_Texture* AssetCache::useSharedTexture(const std::string& assetId, uint64_t contentKey,
+                                          int refCount) {
+    auto& shared = shared_[static_cast<size_t>(AssetType::Texture)];
+    auto it = shared.find(contentKey);
+    if (contentKey == 0 || it == shared.end()) {
+        return nullptr;
+    }
+
+    CachedTexture ct;
+    ct.texture = static_cast<SDL_Texture*>(it->second.payload);
+    ct.width = it->second.width;
+    ct.height = it->second.height;
+    ct.refCount = refCount;
+    textures_[assetId] = ct;
+    addShared(AssetType::Texture, assetId, contentKey, it->second);
+    trackAsset(AssetType::Texture, assetId, textureBytes(ct));
+    stats_.sharedLoads++;
+    return ct.texture;
+}
+
+Mix_Chunk* AssetCache::useSharedSound(const std::string& assetId, uint64_t contentKey) {
+    auto& shared = shared_[static_cast<size_t>(AssetType::Sound)];
+    auto it = shared.find(contentKey);
+    if (contentKey == 0 || it == shared.end()) {
+        return nullptr;
+    }
+
+    Mix_Chunk* chunk = static_cast<Mix_Chunk*>(it->second.payload);
+    size_t bytes = it->second.bytes;
+    sounds_[assetId] = chunk;
+    addShared(AssetType::Sound, assetId, contentKey, it->second);
+    trackAsset(AssetType::Sound, assetId, bytes);
+    stats_.sharedLoads++;
+    return chunk;
+}
+
+void AssetCache::addShared(AssetType type, const std::string& assetId, uint64_t contentKey,
+                           const SharedPayload& payload) {
+    if (contentKey == 0) {
+        return;
+    }
+    SharedPayload& entry = shared_[static_cast<size_t>(type)][contentKey];
+    if (entry.users == 0) {
+        entry = payload;
+    }
+    entry.users++;
+    contentKeys_[static_cast<size_t>(type)][assetId] = contentKey;
+}
+
+size_t AssetCache::getSharedUsers(AssetType type, const std::string& assetId) const {
+    const auto& keys = contentKeys_[static_cast<size_t>(type)];
+    auto keyIt = keys.find(assetId);
+    if (keyIt == keys.end()) {
+        return 1;
+    }
+    const auto& shared = shared_[static_cast<size_t>(type)];
+    auto it = shared.find(keyIt->second);
+    return it != shared.end() ? it->second.users : 1;
+}
+
+bool AssetCache::releaseShared(AssetType type, const std::string& assetId) {
+    auto& keys = contentKeys_[static_cast<size_t>(type)];
+    auto keyIt = keys.find(assetId);
+    if (keyIt == keys.end()) {
+        return true;    // Never shared: the caller owns it
+    }
+
+    auto& shared = shared_[static_cast<size_t>(type)];
+    auto it = shared.find(keyIt->second);
+    keys.erase(keyIt);
+    if (it == shared.end()) {
+        return true;
+    }
+    if (--it->second.users > 0) {
+        return false;
+    }
+    shared.erase(it);
+    return true;
+}
+
+// === Memory budgets ===
+
+void AssetCache::setMemoryBudget(const MemoryBudget& budget) {
+    budget_ = budget;
+    enforceBudget(AssetType::Texture);
+    enforceBudget(AssetType::Sprite);
+    enforceBudget(AssetType::Sound);
+    enforceBudget(AssetType::Music);
+}
+
+bool AssetCache::evict(AssetType type, const std::string& assetId) {
+    if (type == AssetType::Data || !freeAsset(type, assetId)) {
+        return false;
+    }
+    untrackAsset(type, assetId);
+    return true;
+}
+
+size_t AssetCache::getBudget(AssetType type) const {
+    switch (type) {
+        case AssetType::Texture: return budget_.textures;
+        case AssetType::Sprite:  return budget_.sprites;
+        case AssetType::Sound:   return budget_.sounds;
+        case AssetType::Music:   return budget_.music;
+        default:                 return 0;
+    }
+}
+
+void AssetCache::trackAsset(AssetType type, const std::string& key, size_t bytes) {
+    LRUList& lru = lru_[static_cast<size_t>(type)];
+
+    untrackAsset(type, key);
+    lru.order.push_front(key);
+    lru.entries[key] = {lru.order.begin(), bytes};
+    lru.bytesUsed += bytes;
+
+    updateHandle(type, key);
+
+    if (evictedAssets_.erase(key)) {
+        stats_.reloads++;
+    }
+
+    enforceBudget(type);
+}
+
+void AssetCache::touchAsset(AssetType type, const std::string& key) {
+    LRUList& lru = lru_[static_cast<size_t>(type)];
+    auto it = lru.entries.find(key);
+    if (it != lru.entries.end()) {
+        lru.order.splice(lru.order.begin(), lru.order, it->second.position);
+    }
+}
+
+void AssetCache::untrackAsset(AssetType type, const std::string& key) {
+    LRUList& lru = lru_[static_cast<size_t>(type)];
+    auto it = lru.entries.find(key);
+    if (it != lru.entries.end()) {
+        lru.bytesUsed -= it->second.bytes;
+        lru.order.erase(it->second.position);
+        lru.entries.erase(it);
+        updateHandle(type, key);
+    }
+}
+
+void AssetCache::enforceBudget(AssetType type) {
+    LRUList& lru = lru_[static_cast<size_t>(type)];
+    size_t budget = getBudget(type);
+    if (budget == 0) {
+        return;
+    }
+
+    // Walk from least recently used; the most recent entry (usually the
+    // asset just loaded) always stays
+    auto it = lru.order.end();
+    while (lru.bytesUsed > budget) {
+        if (it == lru.order.begin() || --it == lru.order.begin()) {
+            break;
+        }
+
+        std::string key = *it;
+        if (!freeAsset(type, key)) {
+            continue;  // Still in use
+        }
+
+        auto entry = lru.entries.find(key);
+        lru.bytesUsed -= entry->second.bytes;
+        lru.entries.erase(entry);
+        it = lru.order.erase(it);
+        updateHandle(type, key);
+
+        evictedAssets_.insert(key);
+        stats_.evictions++;
+    }
+}
+
+bool AssetCache::freeAsset(AssetType type, const std::string& key) {
+    switch (type) {
+        case AssetType::Texture: {
+            auto it = textures_.find(key);
+            if (it == textures_.end()) {
+                return true;
+            }
+            if (it->second.refCount > 0) {
+                return false;
+            }
+            if (releaseShared(AssetType::Texture, key) && it->second.texture) {
+#ifdef SDL_h_
+                SDL_DestroyTexture(it->second.texture);
+#endif
+            }
+            textures_.erase(it);
+            return true;
+        }
+
+        case AssetType::Sprite: {
+            auto it = sprites_.find(key);
+            if (it == sprites_.end()) {
+                return true;
+            }
+            // Someone besides the cache still holds it
+            if (it->second.use_count() > 1) {
+                return false;
+            }
+            sprites_.erase(it);
+            return true;
+        }
+
+        case AssetType::Sound: {
+#ifdef SDL_h_
+            auto it = sounds_.find(key);
+            if (it == sounds_.end()) {
+                return true;
+            }
+            // Chunks still playing on a channel must stay alive (a chunk
+            // shared with other IDs outlives this one anyway)
+            if (getSharedUsers(AssetType::Sound, key) <= 1) {
+                int channels = Mix_AllocateChannels(-1);
+                for (int i = 0; i < channels; ++i) {
+                    if (Mix_Playing(i) && Mix_GetChunk(i) == it->second) {
+                        return false;
+                    }
+                }
+            }
+            if (releaseShared(AssetType::Sound, key)) {
+                Mix_FreeChunk(it->second);
+            }
+            sounds_.erase(it);
+#endif
+            return true;
+        }
+
+        case AssetType::Music: {
+#ifdef SDL_h_
+            auto it = music_.find(key);
+            if (it == music_.end()) {
+                return true;
+            }
+            // SDL_mixer can't say which music is playing, so keep all of it
+            // while any music plays
+            if (Mix_PlayingMusic()) {
+                return false;
+            }
+            Mix_FreeMusic(it->second);
+            music_.erase(it);
+#endif
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+// === Asynchronous loading ===
+
+std::shared_ptr<TextureRequest> AssetCache::requestTexture(const std::string& assetId) {
+    return queueTextureRequest(assetId, [this, assetId](DecodedTexture& decoded) {
+        bool fromDiskCache = false;
+        if (!readTextureSource(assetId, decoded.sourceData, fromDiskCache, &decoded.timing)) {
+            // Not catalogued: pumpUploads() falls back to getTexture()
+            decoded.loadOnMainThread = true;
+            return;
+        }
+
+        decoded.contentKey = contentKey(decoded.sourceData.data(), decoded.sourceData.size());
+        decodeTexture(decoded);
+
+        // Only freshly extracted data needs writing to the disk cache
+        if (fromDiskCache) {
+            decoded.sourceData.clear();
+        }
+    });
+}
+
+std::shared_ptr<TextureRequest> AssetCache::requestExtractedTexture(const std::string& gameId,
+                                                                    const std::string& spriteName) {
+    std::string cacheKey = "extracted:" + gameId + ":sprite:" + spriteName;
+    std::string basePath = extractedBasePath_.empty() ? gamePath_ : extractedBasePath_;
+
+    return queueTextureRequest(cacheKey, [this, basePath, gameId, spriteName](DecodedTexture& decoded) {
+        StageTimer resolveTimer(&decoded.timing, LoadStage::Resolve);
+        std::string filePath = findExtractedSprite(basePath, gameId, spriteName);
+        resolveTimer.stop();
+        if (filePath.empty()) {
+            decoded.error = "Extracted sprite not found: " + basePath + "/" + gameId + "/sprites/" + spriteName;
+            return;
+        }
+
+        StageTimer readTimer(&decoded.timing, LoadStage::Read);
+        MappedFile file;
+        if (!file.open(filePath)) {
+            decoded.error = "Failed to open " + filePath + ": " + file.getLastError();
+            return;
+        }
+        decoded.contentKey = contentKey(file.data(), file.size());
+        decoded.sourceData.assign(file.data(), file.data() + file.size());
+        decoded.timing.bytesFromDisk += file.size();
+        readTimer.stop();
+        decodeTexture(decoded);
+
+        // Extracted files are not written to the disk cache
+        decoded.sourceData.clear();
+    });
+}
+
+std::shared_ptr<TextureRequest> AssetCache::queueTextureRequest(
+        const std::string& key, std::function<void(DecodedTexture&)> decode) {
+    // Already loaded: the request completes immediately
+    auto it = textures_.find(key);
+    if (it != textures_.end()) {
+        it->second.refCount++;
+        touchAsset(AssetType::Texture, key);
+        stats_.cacheHits++;
+
+        auto request = std::make_shared<TextureRequest>();
+        request->assetId = key;
+        request->state = TextureRequest::State::Ready;
+        request->texture = it->second.texture;
+        request->width = it->second.width;
+        request->height = it->second.height;
+        return request;
+    }
+
+    // Already in flight: share the request
+    auto pendingIt = pendingTextures_.find(key);
+    if (pendingIt != pendingTextures_.end()) {
+        pendingIt->second.refCount++;
+        return pendingIt->second.request;
+    }
+
+    stats_.cacheMisses++;
+
+    auto request = std::make_shared<TextureRequest>();
+    request->assetId = key;
+
+    PendingTexture pending;
+    pending.request = request;
+    pending.refCount = 1;
+    pendingTextures_[key] = pending;
+
+    if (!loadPool_) {
+        loadPool_ = std::make_unique<JobPool>(workerCount_);
+    }
+
+    loadPool_->submit([this, request, decode]() {
+        DecodedTexture decoded;
+        decoded.request = request;
+        decode(decoded);
+
+        std::lock_guard<std::mutex> lock(decodedMutex_);
+        decoded_.push_back(std::move(decoded));
+    });
+
+    return request;
+}
+
+bool AssetCache::readTextureSource(const std::string& assetId, std::vector<uint8_t>& data,
+                                   bool& fromDiskCache, LoadTiming* timing) const {
+    data = loadFromCache(assetId, timing);
+    if (!data.empty()) {
+        fromDiskCache = true;
+        return true;
+    }
+    fromDiskCache = false;
+
+    std::string source, type;
+    int id;
+    if (!parseAssetId(assetId, source, type, id)) {
+        return false;
+    }
+
+    // Same sources as getTexture(), restricted to catalogued files
+    StageTimer resolveTimer(timing, LoadStage::Resolve);
+    if (type == "bitmap") {
+        const CatalogEntry* entry = catalog().findResource(source + ".DAT", NE_RT_BITMAP,
+                                                           static_cast<uint16_t>(id));
+        resolveTimer.stop();
+        if (!entry || !catalog().read(*entry, data, nullptr, timing)) {
+            return false;
+        }
+        wrapBitmapResource(data);
+        return true;
+    } else if (type == "sprite") {
+        const CatalogEntry* entry = catalog().findEntry(source + ".GRP", std::to_string(id));
+        resolveTimer.stop();
+        return entry && catalog().read(*entry, data, nullptr, timing);
+    }
+
+    return false;
+}
+
+void AssetCache::decodeTexture(DecodedTexture& decoded) const {
+#ifdef SDL_h_
+    StageTimer convertTimer(&decoded.timing, LoadStage::Convert);
+
+    // Expand to ARGB here so the main thread only has to copy it
+    BitmapView bitmap;
+    if (parseBitmap(decoded.sourceData.data(), decoded.sourceData.size(), bitmap)) {
+        decoded.width = bitmap.width;
+        decoded.height = bitmap.height;
+        decoded.pixels.resize(static_cast<size_t>(bitmap.width) * bitmap.height);
+        expandBitmap(bitmap, reinterpret_cast<uint8_t*>(decoded.pixels.data()),
+                     static_cast<size_t>(bitmap.width) * 4);
+        return;
+    }
+
+    SDL_RWops* rw = SDL_RWFromConstMem(decoded.sourceData.data(),
+                                       static_cast<int>(decoded.sourceData.size()));
+    if (!rw) {
+        decoded.error = "Failed to create RWops";
+        return;
+    }
+
+    decoded.surface = SDL_LoadBMP_RW(rw, 1);
+    if (!decoded.surface) {
+        decoded.error = "Failed to load BMP: " + std::string(SDL_GetError());
+    }
+#else
+    decoded.error = "SDL2 not available";
+#endif
+}
+
+size_t AssetCache::pumpUploads(double budgetMs) {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    size_t uploaded = 0;
+
+    for (;;) {
+        DecodedTexture decoded;
+        {
+            std::lock_guard<std::mutex> lock(decodedMutex_);
+            if (decoded_.empty()) {
+                break;
+            }
+            decoded = std::move(decoded_.front());
+            decoded_.pop_front();
+        }
+
+        completeUpload(decoded);
+        uploaded++;
+
+        double elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (elapsedMs >= budgetMs) {
+            break;
+        }
+    }
+
+    return uploaded;
+}
+
+void AssetCache::completeUpload(DecodedTexture& decoded) {
+    std::shared_ptr<TextureRequest> request = decoded.request;
+    const std::string key = request->assetId;
+
+#ifdef SDL_h_
+    // References handed out while the request was in flight
+    int refCount = 1;
+    auto pendingIt = pendingTextures_.find(key);
+    if (pendingIt != pendingTextures_.end()) {
+        refCount = pendingIt->second.refCount;
+        pendingTextures_.erase(pendingIt);
+    }
+
+    // A synchronous getTexture() may have loaded it in the meantime
+    auto it = textures_.find(key);
+    if (it == textures_.end()) {
+        if (decoded.loadOnMainThread) {
+            if (getTexture(key)) {
+                it = textures_.find(key);
+                it->second.refCount--;  // Counted below with the request's references
+            } else {
+                decoded.error = lastError_;
+            }
+        } else if (useSharedTexture(key, decoded.contentKey, 0)) {
+            it = textures_.find(key);
+            if (!decoded.sourceData.empty()) {
+                saveToCache(key, decoded.sourceData, AssetType::Texture);
+            }
+            recordLoad(AssetType::Texture, key, decoded.timing);
+        } else if ((!decoded.pixels.empty() || decoded.surface) && renderer_) {
+            StageTimer uploadTimer(&decoded.timing, LoadStage::Upload);
+            CachedTexture ct;
+            if (decoded.surface) {
+                ct.texture = SDL_CreateTextureFromSurface(renderer_, decoded.surface);
+                ct.width = decoded.surface->w;
+                ct.height = decoded.surface->h;
+            } else {
+                ct.texture = createPixelTexture(renderer_, decoded.pixels, decoded.width, decoded.height);
+                ct.width = decoded.width;
+                ct.height = decoded.height;
+            }
+            uploadTimer.stop();
+            SDL_Texture* texture = ct.texture;
+            if (texture) {
+                it = textures_.emplace(key, ct).first;
+                addShared(AssetType::Texture, key, decoded.contentKey,
+                          {texture, ct.width, ct.height, textureBytes(ct)});
+                trackAsset(AssetType::Texture, key, textureBytes(ct));
+                stats_.texturesLoaded++;
+                recordLoad(AssetType::Texture, key, decoded.timing);
+
+                if (!decoded.sourceData.empty()) {
+                    saveToCache(key, decoded.sourceData, AssetType::Texture);
+                }
+            } else {
+                decoded.error = "Failed to create texture: " + std::string(SDL_GetError());
+            }
+        } else if (decoded.error.empty()) {
+            decoded.error = "No renderer set";
+        }
+    }
+
+    if (decoded.surface) {
+        SDL_FreeSurface(decoded.surface);
+        decoded.surface = nullptr;
+    }
+
+    if (it != textures_.end()) {
+        it->second.refCount += refCount;
+        touchAsset(AssetType::Texture, key);
+        request->state = TextureRequest::State::Ready;
+        request->texture = it->second.texture;
+        request->width = it->second.width;
+        request->height = it->second.height;
+        return;
+    }
+#else
+    pendingTextures_.erase(key);
+    if (decoded.error.empty()) {
+        decoded.error = "SDL2 not available";
+    }
+#endif
+
+    request->state = TextureRequest::State::Failed;
+    request->error = decoded.error;
+    lastError_ = decoded.error;
+}
+
+void AssetCache::releaseRequest(const std::shared_ptr<TextureRequest>& request) {
+    if (!request) {
+        return;
+    }
+    if (request->state == TextureRequest::State::Ready) {
+        releaseTexture(request->assetId);
+        return;
+    }
+
+    // Still in flight: completeUpload() hands out one reference fewer
+    auto it = pendingTextures_.find(request->assetId);
+    if (it != pendingTextures_.end() && it->second.request == request && it->second.refCount > 0) {
+        it->second.refCount--;
+    }
+}
+
+void AssetCache::waitForDecodes() {
+    if (loadPool_) {
+        loadPool_->waitIdle();
+    }
+}
+
+void AssetCache::cancelRequests(const std::string& reason) {
+    waitForDecodes();
+
+    std::deque<DecodedTexture> decoded;
+    {
+        std::lock_guard<std::mutex> lock(decodedMutex_);
+        decoded.swap(decoded_);
+    }
+
+#ifdef SDL_h_
+    for (auto& d : decoded) {
+        if (d.surface) {
+            SDL_FreeSurface(d.surface);
+        }
+    }
+#endif
+
+    for (auto& pair : pendingTextures_) {
+        pair.second.request->state = TextureRequest::State::Failed;
+        pair.second.request->error = reason;
+    }
+    pendingTextures_.clear();
+}
+
+size_t AssetCache::preload(const std::string& pattern) {
+    // Only IDs starting with the literal part of the pattern can match, and
+    // the pack hands those back without scanning the rest of its index
+    std::string prefix = pattern.substr(0, pattern.find_first_of("*?"));
+    std::string_view rest = std::string_view(pattern).substr(prefix.size());
+
+    std::vector<CachePackInfo> matches;
+    for (auto& info : pack_->list(prefix)) {
+        if (globMatch(rest, std::string_view(info.id).substr(prefix.size()))) {
+            matches.push_back(std::move(info));
+        }
+    }
+
+    // Read in (source file, offset) order so each game file is walked front
+    // to back; the pack offset orders what has no recorded source
+    auto sourceOf = [this](const CachePackInfo& info) -> std::pair<const std::string*, uint32_t> {
+        static const std::string none;
+        auto it = cacheIndex_.find(info.id);
+        if (it == cacheIndex_.end()) {
+            return {&none, 0};
+        }
+        return {&it->second.sourcePath, it->second.sourceOffset};
+    };
+    std::sort(matches.begin(), matches.end(), [&sourceOf](const CachePackInfo& a, const CachePackInfo& b) {
+        auto sa = sourceOf(a);
+        auto sb = sourceOf(b);
+        int cmp = sa.first->compare(*sb.first);
+        if (cmp != 0) {
+            return cmp < 0;
+        }
+        if (sa.second != sb.second) {
+            return sa.second < sb.second;
+        }
+        return a.offset < b.offset;
+    });
+
+    // Sound or data read (and for sounds, decoded) on a worker
+    struct PreloadedAsset {
+        std::string assetId;
+        AssetType type = AssetType::Data;
+        Mix_Chunk* chunk = nullptr;
+        uint64_t contentKey = 0;
+        LoadTiming timing;
+    };
+
+    if (!loadPool_) {
+        loadPool_ = std::make_unique<JobPool>(workerCount_);
+    }
 
-    std::string source, type;
-    int id;
-    if (!parseAssetId(assetId, source, type, id)) {
-        lastError_ = "Invalid asset ID: " + assetId;
-        return {};
+    // The whole batch goes to the worker pool: textures through the
+    // request queue, sounds and data as plain jobs
+    std::vector<std::shared_ptr<TextureRequest>> requests;
+    std::vector<PreloadedAsset> assets;
+    assets.reserve(matches.size());
+    for (const auto& info : matches) {
+        AssetType type = static_cast<AssetType>(info.tag);
+        if (type == AssetType::Texture) {
+            requests.push_back(requestTexture(info.id));
+            continue;
+        }
+        if (type == AssetType::Sound && sounds_.count(info.id)) {
+            touchAsset(AssetType::Sound, info.id);
+            stats_.cacheHits++;
+            continue;
+        }
+        PreloadedAsset asset;
+        asset.assetId = info.id;
+        asset.type = type == AssetType::Sound ? type : AssetType::Data;
+        assets.push_back(std::move(asset));
+    }
+    for (auto& asset : assets) {
+        PreloadedAsset* out = &asset;
+        loadPool_->submit([this, out]() {
+            std::vector<uint8_t> data = loadFromCache(out->assetId, &out->timing);
+            out->contentKey = contentKey(data.data(), data.size());
+#ifdef SDL_h_
+            if (out->type == AssetType::Sound && !data.empty()) {
+                StageTimer convertTimer(&out->timing, LoadStage::Convert);
+                SDL_RWops* rw = SDL_RWFromConstMem(data.data(), static_cast<int>(data.size()));
+                out->chunk = rw ? Mix_LoadWAV_RW(rw, 1) : nullptr;
+            }
+#endif
+        });
     }
+    waitForDecodes();
 
-    std::vector<uint8_t> data;
-    if (!loadFromNE(source, type, id, data)) {
-        return {};
+    // Cache the sounds and account for everything here on the main thread
+    for (auto& asset : assets) {
+        if (asset.contentKey == 0) {
+            continue;
+        }
+        if (asset.type == AssetType::Data) {
+            stats_.cacheHits++;
+            recordLoad(AssetType::Data, asset.assetId, asset.timing);
+            continue;
+        }
+#ifdef SDL_h_
+        stats_.cacheMisses++;
+        if (useSharedSound(asset.assetId, asset.contentKey)) {
+            if (asset.chunk) {
+                Mix_FreeChunk(asset.chunk);
+            }
+            recordLoad(AssetType::Sound, asset.assetId, asset.timing);
+        } else if (asset.chunk) {
+            sounds_[asset.assetId] = asset.chunk;
+            addShared(AssetType::Sound, asset.assetId, asset.contentKey,
+                      {asset.chunk, 0, 0, asset.chunk->alen});
+            trackAsset(AssetType::Sound, asset.assetId, asset.chunk->alen);
+            stats_.soundsLoaded++;
+            recordLoad(AssetType::Sound, asset.assetId, asset.timing);
+        }
+#endif
     }
 
-    saveToCache(assetId, data);
-    return data;
-}
+    if (!requests.empty()) {
+        pumpUploads(std::numeric_limits<double>::infinity());
 
-void AssetCache::releaseTexture(const std::string& assetId) {
-    auto it = textures_.find(assetId);
-    if (it != textures_.end()) {
-        it->second.refCount--;
-        // Don't actually free - keep in cache
-    }
-}
-
-void AssetCache::preload(const std::string& pattern) {
-    // Convert glob pattern to regex
-    std::string regexStr = pattern;
-    // Escape regex special chars except * and ?
-    for (size_t i = 0; i < regexStr.size(); ++i) {
-        if (regexStr[i] == '*') {
-            regexStr.replace(i, 1, ".*");
-            i++;
-        } else if (regexStr[i] == '?') {
-            regexStr[i] = '.';
-        }
-    }
-
-    std::regex re(regexStr);
-
-    // Scan cache index for matches
-    for (const auto& pair : cacheIndex_) {
-        if (std::regex_match(pair.first, re)) {
-            // Trigger load based on type
-            switch (pair.second.type) {
-                case AssetType::Texture:
-                    getTexture(pair.first);
-                    break;
-                case AssetType::Sound:
-                    getSound(pair.first);
-                    break;
-                default:
-                    getData(pair.first);
-                    break;
+        // Keep them cached, but under the texture budget like any other
+        for (const auto& request : requests) {
+            if (request->state == TextureRequest::State::Ready) {
+                releaseTexture(request->assetId);
             }
         }
     }
+
+    return matches.size();
 }
 
 AssetCache::Stats AssetCache::getStats() const {
     stats_.texturesCached = textures_.size();
+    stats_.memoryUsed = 0;
+    for (const auto& lru : lru_) {
+        stats_.memoryUsed += lru.bytesUsed;
+    }
+    for (const auto& pair : atlases_) {
+        stats_.memoryUsed += pair.second->getMemoryBytes();
+    }
+
+    // Every asset ID is budgeted at full size; shared payloads exist once
+    stats_.bytesShared = 0;
+    for (const auto& shared : shared_) {
+        for (const auto& pair : shared) {
+            stats_.bytesShared += (pair.second.users - 1) * pair.second.bytes;
+        }
+    }
+    stats_.memoryUsed -= stats_.bytesShared;
     return stats_;
 }
 
+void AssetCache::recordLoad(AssetType type, const std::string& assetId, const LoadTiming& timing) {
+    stats_.loads[static_cast<size_t>(type)].record(timing);
+    stats_.bytesFromDisk += timing.bytesFromDisk;
+    stats_.bytesFromCache += timing.bytesFromCache;
+
+    // Keep the slowest few, slowest first
+    auto& slowest = stats_.slowestLoads;
+    double ms = timing.getTotalMs();
+    if (slowest.size() == SLOW_LOAD_COUNT && ms <= slowest.back().timing.getTotalMs()) {
+        return;
+    }
+    auto pos = std::find_if(slowest.begin(), slowest.end(), [ms](const SlowLoad& load) {
+        return load.timing.getTotalMs() < ms;
+    });
+    slowest.insert(pos, SlowLoad{assetId, type, timing});
+    if (slowest.size() > SLOW_LOAD_COUNT) {
+        slowest.pop_back();
+    }
+}
+
+std::string AssetCache::getStatsJson() const {
+    Stats stats = getStats();
+    std::ostringstream out;
+
+    out << "{\n"
+        << "  \"texturesLoaded\": " << stats.texturesLoaded << ",\n"
+        << "  \"texturesCached\": " << stats.texturesCached << ",\n"
+        << "  \"soundsLoaded\": " << stats.soundsLoaded << ",\n"
+        << "  \"cacheHits\": " << stats.cacheHits << ",\n"
+        << "  \"cacheMisses\": " << stats.cacheMisses << ",\n"
+        << "  \"memoryUsed\": " << stats.memoryUsed << ",\n"
+        << "  \"evictions\": " << stats.evictions << ",\n"
+        << "  \"reloads\": " << stats.reloads << ",\n"
+        << "  \"sharedLoads\": " << stats.sharedLoads << ",\n"
+        << "  \"bytesShared\": " << stats.bytesShared << ",\n"
+        << "  \"bytesFromDisk\": " << stats.bytesFromDisk << ",\n"
+        << "  \"bytesFromCache\": " << stats.bytesFromCache << ",\n";
+
+    out << "  \"loads\": {";
+    for (size_t i = 0; i < ASSET_TYPE_COUNT; ++i) {
+        const LoadProfile& profile = stats.loads[i];
+        out << (i ? ",\n" : "\n") << "    \"" << assetTypeName(static_cast<AssetType>(i))
+            << "\": {\"total\": ";
+        writeHistogramJson(out, profile.total);
+        out << ", \"stages\": {";
+        for (size_t s = 0; s < LOAD_STAGE_COUNT; ++s) {
+            out << (s ? ", " : "") << "\"" << getLoadStageName(static_cast<LoadStage>(s)) << "\": ";
+            writeHistogramJson(out, profile.stages[s]);
+        }
+        out << "}}";
+    }
+    out << "\n  },\n";
+
+    out << "  \"slowestLoads\": [";
+    for (size_t i = 0; i < stats.slowestLoads.size(); ++i) {
+        const SlowLoad& load = stats.slowestLoads[i];
+        out << (i ? ",\n" : "\n") << "    {\"asset\": ";
+        writeJsonString(out, load.assetId);
+        out << ", \"type\": \"" << assetTypeName(load.type) << "\""
+            << ", \"ms\": " << load.timing.getTotalMs()
+            << ", \"bytesFromDisk\": " << load.timing.bytesFromDisk
+            << ", \"bytesFromCache\": " << load.timing.bytesFromCache
+            << ", \"stages\": {";
+        for (size_t s = 0; s < LOAD_STAGE_COUNT; ++s) {
+            out << (s ? ", " : "") << "\"" << getLoadStageName(static_cast<LoadStage>(s))
+                << "\": " << load.timing.stageMs[s];
+        }
+        out << "}}";
+    }
+    out << "\n  ]\n}\n";
+
+    return out.str();
+}
+
 std::string AssetCache::makeAssetId(const std::string& source, const std::string& type, int id) {
     return source + ":" + type + ":" + std::to_string(id);
 }
@@ -430,67 +1772,65 @@ bool AssetCache::parseAssetId(const std::string& assetId, std::string& source, s
 }
 
 bool AssetCache::loadFromNE(const std::string& source, const std::string& type, int id,
-                            std::vector<uint8_t>& data) {
-    // Get or open NE file
-    auto it = neFiles_.find(source);
-    if (it == neFiles_.end()) {
-        auto ne = std::make_unique<NEResourceExtractor>();
-        std::string nePath = gamePath_ + "/SSGWINCD/" + source + ".DAT";
-        if (!fs::exists(nePath)) {
-            nePath = gamePath_ + "/" + source + ".DAT";
-        }
-        if (!ne->open(nePath)) {
-            lastError_ = ne->getLastError();
+                            std::vector<uint8_t>& data, LoadTiming* timing) {
+    uint16_t resType = neResourceType(type);
+
+    // Catalogued resources are read directly, without opening the NE file
+    StageTimer resolveTimer(timing, LoadStage::Resolve);
+    const CatalogEntry* entry = catalog().findResource(source + ".DAT", resType,
+                                                       static_cast<uint16_t>(id));
+    if (entry) {
+        resolveTimer.stop();
+        if (!catalog().read(*entry, data, &lastError_, timing)) {
             return false;
         }
-        neFiles_[source] = std::move(ne);
-        it = neFiles_.find(source);
-    }
-
-    // Determine resource type
-    uint16_t resType = NE_RT_RCDATA;
-    if (type == "bitmap") {
-        resType = NE_RT_BITMAP;
-    } else if (type == "font") {
-        resType = NE_RT_FONT;
-    }
+    } else {
+        // Get or open NE file
+        auto it = neFiles_.find(source);
+        if (it == neFiles_.end()) {
+            auto ne = std::make_unique<NEResourceExtractor>();
+            std::string nePath = findInGameDirs({"SSGWINCD", ""}, source + ".DAT");
+            if (nePath.empty()) {
+                nePath = gamePath_ + "/" + source + ".DAT";
+            }
+            if (!ne->open(nePath)) {
+                lastError_ = ne->getLastError();
+                return false;
+            }
+            neFiles_[source] = std::move(ne);
+            it = neFiles_.find(source);
+        }
+        resolveTimer.stop();
 
-    data = it->second->extractResource(resType, static_cast<uint16_t>(id));
-    if (data.empty()) {
-        lastError_ = it->second->getLastError();
-        return false;
+        StageTimer readTimer(timing, LoadStage::Read);
+        data = it->second->extractResource(resType, static_cast<uint16_t>(id));
+        readTimer.stop();
+        if (data.empty()) {
+            lastError_ = it->second->getLastError();
+            return false;
+        }
+        if (timing) {
+            timing->bytesFromDisk += data.size();
+        }
     }
 
     // If bitmap, add BMP header
-    if (type == "bitmap" && data.size() > 40) {
-        std::vector<uint8_t> bmp;
-        bmp.reserve(14 + data.size());
-
-        // BMP file header
-        uint32_t fileSize = 14 + static_cast<uint32_t>(data.size());
-        uint32_t headerSize = *reinterpret_cast<uint32_t*>(data.data());
-        uint16_t bitCount = *reinterpret_cast<uint16_t*>(data.data() + 14);
-        uint32_t paletteSize = (bitCount <= 8) ? (1u << bitCount) * 4 : 0;
-        uint32_t dataOffset = 14 + headerSize + paletteSize;
-
-        bmp.push_back('B');
-        bmp.push_back('M');
-        bmp.insert(bmp.end(), reinterpret_cast<uint8_t*>(&fileSize),
-                   reinterpret_cast<uint8_t*>(&fileSize) + 4);
-        bmp.push_back(0); bmp.push_back(0);  // Reserved
-        bmp.push_back(0); bmp.push_back(0);  // Reserved
-        bmp.insert(bmp.end(), reinterpret_cast<uint8_t*>(&dataOffset),
-                   reinterpret_cast<uint8_t*>(&dataOffset) + 4);
-        bmp.insert(bmp.end(), data.begin(), data.end());
-
-        data = std::move(bmp);
+    if (type == "bitmap") {
+        wrapBitmapResource(data);
     }
 
     return true;
 }
 
 bool AssetCache::loadFromGrp(const std::string& source, const std::string& name,
-                             std::vector<uint8_t>& data) {
+                             std::vector<uint8_t>& data, LoadTiming* timing) {
+    StageTimer resolveTimer(timing, LoadStage::Resolve);
+    const CatalogEntry* entry = catalog().findEntry(source + ".GRP", name);
+    if (entry) {
+        resolveTimer.stop();
+        return catalog().read(*entry, data, &lastError_, timing);
+    }
+
     auto it = grpFiles_.find(source);
     if (it == grpFiles_.end()) {
         auto grp = std::make_unique<GrpArchive>();
@@ -502,141 +1842,239 @@ bool AssetCache::loadFromGrp(const std::string& source, const std::string& name,
         grpFiles_[source] = std::move(grp);
         it = grpFiles_.find(source);
     }
+    resolveTimer.stop();
 
+    // Uncatalogued entries are read and decompressed in one call
+    StageTimer readTimer(timing, LoadStage::Read);
     data = it->second->extract(name);
+    readTimer.stop();
+    if (timing) {
+        timing->bytesFromDisk += data.size();
+    }
     return !data.empty();
 }
 
+bool AssetCache::openCachePack() {
+    // Drop the old one-file-per-asset cache; the pack supersedes it
+    std::error_code ec;
+    if (fs::exists(cachePath_ + "/cache_index.dat", ec)) {
+        fs::remove(cachePath_ + "/cache_index.dat", ec);
+        for (const auto& entry : fs::directory_iterator(cachePath_, ec)) {
+            if (entry.path().extension() == ".cache") {
+                fs::remove(entry.path(), ec);
+            }
+        }
+    }
+
+    loadCacheIndex();
+
+    if (!pack_->open(cachePath_ + "/asset_cache.pack")) {
+        lastError_ = pack_->getLastError();
+        return false;
+    }
+    return true;
+}
+
 bool AssetCache::loadCacheIndex() {
-    std::string indexPath = cachePath_ + "/cache_index.dat";
-    std::ifstream file(indexPath, std::ios::binary);
+    cacheIndex_.clear();
+    cacheIndexDirty_ = false;
+
+    std::ifstream file(cachePath_ + "/cache_meta.dat", std::ios::binary);
     if (!file) {
         return false;
     }
 
-    // Simple binary format: count, then entries
-    uint32_t count;
-    file.read(reinterpret_cast<char*>(&count), sizeof(count));
-
-    for (uint32_t i = 0; i < count && file; ++i) {
-        uint32_t idLen;
-        file.read(reinterpret_cast<char*>(&idLen), sizeof(idLen));
+    auto readValue = [&file](auto& value) {
+        file.read(reinterpret_cast<char*>(&value), sizeof(value));
+    };
+    auto readString = [&file, &readValue](std::string& str) {
+        uint32_t length = 0;
+        readValue(length);
+        if (!file || length > 4096) {
+            file.setstate(std::ios::failbit);
+            return;
+        }
+        str.resize(length);
+        file.read(str.data(), length);
+    };
 
-        std::string id(idLen, '\0');
-        file.read(id.data(), idLen);
+    char magic[4];
+    uint32_t version = 0;
+    uint32_t count = 0;
+    file.read(magic, 4);
+    readValue(version);
+    readValue(count);
+    if (!file || std::memcmp(magic, CACHE_INDEX_MAGIC, 4) != 0 || version != CACHE_INDEX_VERSION) {
+        return false;
+    }
 
-        AssetMeta meta;
-        meta.id = id;
-        file.read(reinterpret_cast<char*>(&meta.type), sizeof(meta.type));
-        file.read(reinterpret_cast<char*>(&meta.crc32), sizeof(meta.crc32));
-        file.read(reinterpret_cast<char*>(&meta.timestamp), sizeof(meta.timestamp));
+    for (uint32_t i = 0; i < count; ++i) {
+        AssetMeta meta{};
+        uint32_t type = 0;
+        readString(meta.id);
+        readValue(type);
+        readString(meta.sourcePath);
+        readValue(meta.sourceOffset);
+        readValue(meta.crc32);
+        readValue(meta.timestamp);
+        readValue(meta.width);
+        readValue(meta.height);
+        readValue(meta.sourceSize);
+        readValue(meta.sourceModified);
+        if (!file) {
+            cacheIndex_.clear();
+            return false;
+        }
 
-        cacheIndex_[id] = meta;
+        meta.type = static_cast<AssetType>(type);
+        cacheIndex_[meta.id] = std::move(meta);
     }
 
     return true;
 }
 
 bool AssetCache::saveCacheIndex() {
-    std::string indexPath = cachePath_ + "/cache_index.dat";
-    std::ofstream file(indexPath, std::ios::binary);
-    if (!file) {
-        return false;
-    }
+    // Write to a temp file and rename, so a crash never leaves a torn index
+    std::string path = cachePath_ + "/cache_meta.dat";
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+
+        auto writeValue = [&file](const auto& value) {
+            file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        };
+        auto writeString = [&file, &writeValue](const std::string& str) {
+            writeValue(static_cast<uint32_t>(str.size()));
+            file.write(str.data(), str.size());
+        };
+
+        file.write(CACHE_INDEX_MAGIC, 4);
+        writeValue(CACHE_INDEX_VERSION);
+        writeValue(static_cast<uint32_t>(cacheIndex_.size()));
+
+        for (const auto& pair : cacheIndex_) {
+            const AssetMeta& meta = pair.second;
+            writeString(meta.id);
+            writeValue(static_cast<uint32_t>(meta.type));
+            writeString(meta.sourcePath);
+            writeValue(meta.sourceOffset);
+            writeValue(meta.crc32);
+            writeValue(meta.timestamp);
+            writeValue(meta.width);
+            writeValue(meta.height);
+            writeValue(meta.sourceSize);
+            writeValue(meta.sourceModified);
+        }
 
-    uint32_t count = static_cast<uint32_t>(cacheIndex_.size());
-    file.write(reinterpret_cast<char*>(&count), sizeof(count));
+        if (!file) {
+            return false;
+        }
+    }
 
-    for (const auto& pair : cacheIndex_) {
-        uint32_t idLen = static_cast<uint32_t>(pair.first.size());
-        file.write(reinterpret_cast<const char*>(&idLen), sizeof(idLen));
-        file.write(pair.first.c_str(), idLen);
-        file.write(reinterpret_cast<const char*>(&pair.second.type), sizeof(pair.second.type));
-        file.write(reinterpret_cast<const char*>(&pair.second.crc32), sizeof(pair.second.crc32));
-        file.write(reinterpret_cast<const char*>(&pair.second.timestamp), sizeof(pair.second.timestamp));
+    std::error_code ec;
+    fs::rename(tempPath, path, ec);
+    if (ec) {
+        return false;
     }
 
+    cacheIndexDirty_ = false;
     return true;
 }
 
-std::string AssetCache::getCacheFilePath(const std::string& assetId) const {
-    // Convert asset ID to safe filename
-    std::string filename = assetId;
-    std::replace(filename.begin(), filename.end(), ':', '_');
-    std::replace(filename.begin(), filename.end(), '/', '_');
-    std::replace(filename.begin(), filename.end(), '\\', '_');
-    return cachePath_ + "/" + filename + ".cache";
+std::string AssetCache::findSourceFile(const std::string& assetId, uint32_t& offset) const {
+    offset = 0;
+
+    std::string source, type;
+    int id;
+    if (!parseAssetId(assetId, source, type, id)) {
+        return {};
+    }
+
+    // Same lookups as loadFromGrp() / loadFromNE()
+    if (type == "sprite") {
+        std::string filename = source + ".GRP";
+        if (const CatalogFile* file = catalog().findFile(filename)) {
+            if (const CatalogEntry* entry = catalog().findEntry(filename, std::to_string(id))) {
+                offset = entry->offset;
+            }
+            return catalog().getFilePath(*file);
+        }
+        return gamePath_ + "/ASSETS/" + filename;
+    }
+
+    std::string filename = source + ".DAT";
+    if (const CatalogFile* file = catalog().findFile(filename)) {
+        if (const CatalogEntry* entry = catalog().findResource(filename, neResourceType(type),
+                                                               static_cast<uint16_t>(id))) {
+            offset = entry->offset;
+        }
+        return catalog().getFilePath(*file);
+    }
+
+    std::string path = findInGameDirs({"SSGWINCD", ""}, filename);
+    return path.empty() ? gamePath_ + "/" + filename : path;
 }
 
-bool AssetCache::saveToCache(const std::string& assetId, const std::vector<uint8_t>& data) {
-    std::string path = getCacheFilePath(assetId);
-    std::ofstream file(path, std::ios::binary);
-    if (!file) {
+bool AssetCache::extractAsset(const std::string& assetId, std::vector<uint8_t>& data) {
+    std::string source, type;
+    int id;
+    if (!parseAssetId(assetId, source, type, id)) {
         return false;
     }
 
-    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    if (type == "sprite") {
+        return loadFromGrp(source, std::to_string(id), data);
+    }
+    return loadFromNE(source, type, id, data);
+}
+
+bool AssetCache::saveToCache(const std::string& assetId, const std::vector<uint8_t>& data,
+                             AssetType type) {
+    if (!pack_->write(assetId, data.data(), data.size(), static_cast<uint32_t>(type))) {
+        lastError_ = pack_->getLastError();
+        return false;
+    }
 
-    // Update index
-    AssetMeta meta;
+    // Remember the source file's state so validateCache() can skip it
+    // while it stays unchanged
+    AssetMeta meta{};
     meta.id = assetId;
+    meta.type = type;
+    meta.sourcePath = findSourceFile(assetId, meta.sourceOffset);
     meta.crc32 = calculateCRC32(data);
     meta.timestamp = static_cast<uint64_t>(std::time(nullptr));
-    cacheIndex_[assetId] = meta;
+    meta.sourceSize = fileBytes(meta.sourcePath);
+    meta.sourceModified = fileModifiedTime(meta.sourcePath);
+    cacheIndex_[assetId] = std::move(meta);
+    cacheIndexDirty_ = true;
 
     stats_.texturesCached++;
     return true;
 }
 
-std::vector<uint8_t> AssetCache::loadFromCache(const std::string& assetId) {
-    std::string path = getCacheFilePath(assetId);
-    std::ifstream file(path, std::ios::binary | std::ios::ate);
-    if (!file) {
-        return {};
+std::vector<uint8_t> AssetCache::loadFromCache(const std::string& assetId,
+                                               LoadTiming* timing) const {
+    StageTimer readTimer(timing, LoadStage::Read);
+    std::vector<uint8_t> data;
+    pack_->read(assetId, data);
+    if (timing) {
+        timing->bytesFromCache += data.size();
     }
-
-    auto size = file.tellg();
-    file.seekg(0);
-
-    std::vector<uint8_t> data(static_cast<size_t>(size));
-    file.read(reinterpret_cast<char*>(data.data()), size);
-
     return data;
 }
 
 uint32_t AssetCache::calculateCRC32(const std::vector<uint8_t>& data) {
-    uint32_t crc = 0xFFFFFFFF;
-    for (uint8_t byte : data) {
-        crc = crc32Table[(crc ^ byte) & 0xFF] ^ (crc >> 8);
-    }
-    return crc ^ 0xFFFFFFFF;
+    return crc32(data.data(), data.size());
 }
 
 std::vector<std::pair<std::string, std::string>> AssetCache::listNEResources(const std::string& filename) {
     std::vector<std::pair<std::string, std::string>> result;
 
-    // Build full path
-    std::string fullPath = gamePath_ + "/SSGWINCD/" + filename;
-    if (!fs::exists(fullPath)) {
-        fullPath = gamePath_ + "/" + filename;
-        if (!fs::exists(fullPath)) {
-            return result;
-        }
-    }
-
-    // Check if we have this file cached
-    auto it = neFiles_.find(filename);
-    if (it == neFiles_.end()) {
-        auto extractor = std::make_unique<NEResourceExtractor>();
-        if (!extractor->open(fullPath)) {
-            return result;
-        }
-        neFiles_[filename] = std::move(extractor);
-        it = neFiles_.find(filename);
-    }
-
     // Get all resources
-    auto resources = it->second->listResources();
+    auto resources = getNEResourceList(filename);
     for (const auto& res : resources) {
         char info[128];
         snprintf(info, sizeof(info), "Type: %s  ID: %u  Size: %u bytes",
@@ -649,27 +2087,29 @@ std::vector<std::pair<std::string, std::string>> AssetCache::listNEResources(con
 }
 
 std::vector<Resource> AssetCache::getNEResourceList(const std::string& filename) {
-    // Build full path - check multiple game directories
-    std::vector<std::string> searchPaths = {
-        gamePath_ + "/SSGWINCD/" + filename,      // Gizmos & Gadgets
-        gamePath_ + "/ONWINCD/" + filename,       // Operation Neptune (alternate)
-        gamePath_ + "/ONWINCD/INSTALL/" + filename, // Neptune install dir
-        gamePath_ + "/sso_extract/" + filename,   // OutNumbered
-        gamePath_ + "/ssr_extract/" + filename,   // Spellbound
-        gamePath_ + "/tms_extract/" + filename,   // Treasure MathStorm
-        gamePath_ + "/iso/SSGWINCD/" + filename,  // ISO mount paths
-        gamePath_ + "/iso/INSTALL/" + filename,
-        gamePath_ + "/" + filename                // Root fallback
-    };
-
-    std::string fullPath;
-    for (const auto& path : searchPaths) {
-        if (fs::exists(path)) {
-            fullPath = path;
-            break;
+    // Catalogued files are listed without probing or parsing the NE header
+    if (const CatalogFile* file = catalog().findFile(filename)) {
+        if (file->kind == static_cast<uint8_t>(CatalogFileKind::NE)) {
+            std::vector<Resource> result;
+            result.reserve(file->entryCount);
+            for (const CatalogEntry* e = catalog().entriesBegin(*file);
+                 e != catalog().entriesEnd(*file); ++e) {
+                Resource res;
+                res.typeId = e->type;
+                res.id = e->id;
+                res.offset = e->offset;
+                res.size = e->size;
+                res.flags = e->flags;
+                res.name = catalog().getEntryName(*e);
+                res.typeName = NEResourceExtractor::getResourceTypeName(e->type);
+                result.push_back(res);
+            }
+            return result;
         }
     }
 
+    // Build full path - check multiple game directories
+    std::string fullPath = findGameFile(filename);
     if (fullPath.empty()) {
         return {};
     }
@@ -692,12 +2132,9 @@ std::vector<std::string> AssetCache::listGRPFiles(const std::string& filename) {
     std::vector<std::string> result;
 
     // Build full path - GRP files are in ASSETS folder
-    std::string fullPath = gamePath_ + "/ASSETS/" + filename;
-    if (!fs::exists(fullPath)) {
-        fullPath = gamePath_ + "/" + filename;
-        if (!fs::exists(fullPath)) {
-            return result;
-        }
+    std::string fullPath = findInGameDirs({"ASSETS", ""}, filename);
+    if (fullPath.empty()) {
+        return result;
     }
 
     // Check if we have this file cached
@@ -715,27 +2152,15 @@ std::vector<std::string> AssetCache::listGRPFiles(const std::string& filename) {
 }
 
 std::vector<uint8_t> AssetCache::getRawResource(const std::string& filename, uint16_t type, uint16_t id) {
-    // Build full path - check multiple game directories
-    std::vector<std::string> searchPaths = {
-        gamePath_ + "/SSGWINCD/" + filename,      // Gizmos & Gadgets
-        gamePath_ + "/ONWINCD/" + filename,       // Operation Neptune (alternate)
-        gamePath_ + "/ONWINCD/INSTALL/" + filename, // Neptune install dir
-        gamePath_ + "/sso_extract/" + filename,   // OutNumbered
-        gamePath_ + "/ssr_extract/" + filename,   // Spellbound
-        gamePath_ + "/tms_extract/" + filename,   // Treasure MathStorm
-        gamePath_ + "/iso/SSGWINCD/" + filename,  // ISO mount paths
-        gamePath_ + "/iso/INSTALL/" + filename,
-        gamePath_ + "/" + filename                // Root fallback
-    };
-
-    std::string fullPath;
-    for (const auto& path : searchPaths) {
-        if (fs::exists(path)) {
-            fullPath = path;
-            break;
-        }
+    // Catalogued resources are read directly, without opening the NE file
+    if (const CatalogEntry* entry = catalog().findResource(filename, type, id)) {
+        std::vector<uint8_t> data;
+        catalog().read(*entry, data, &lastError_);
+        return data;
     }
 
+    // Build full path - check multiple game directories
+    std::string fullPath = findGameFile(filename);
     if (fullPath.empty()) {
         return {};
     }
@@ -756,118 +2181,65 @@ std::vector<uint8_t> AssetCache::getRawResource(const std::string& filename, uin
 
 SDL_Texture* AssetCache::createTextureFromBitmap(const std::vector<uint8_t>& bitmapData, int* outWidth, int* outHeight) {
 #ifdef SDL_h_
-    if (!renderer_ || bitmapData.size() < 40) {
+    if (!renderer_) {
         return nullptr;
     }
 
-    // Parse BITMAPINFOHEADER
-    const uint8_t* data = bitmapData.data();
-    uint32_t headerSize = *reinterpret_cast<const uint32_t*>(data);
-    int32_t width = *reinterpret_cast<const int32_t*>(data + 4);
-    int32_t height = *reinterpret_cast<const int32_t*>(data + 8);
-    uint16_t planes = *reinterpret_cast<const uint16_t*>(data + 12);
-    uint16_t bitCount = *reinterpret_cast<const uint16_t*>(data + 14);
-    uint32_t compression = *reinterpret_cast<const uint32_t*>(data + 16);
-
-    // Handle negative height (top-down bitmap)
-    bool topDown = height < 0;
-    if (topDown) height = -height;
-
-    if (outWidth) *outWidth = width;
-    if (outHeight) *outHeight = height;
-
-    // Only support uncompressed bitmaps for now
-    if (compression != 0) {
-        lastError_ = "Compressed bitmaps not supported";
+    BitmapView bitmap;
+    if (!parseBitmap(bitmapData.data(), bitmapData.size(), bitmap, &lastError_)) {
         return nullptr;
     }
 
-    // Calculate palette info
-    uint32_t paletteSize = 0;
-    uint32_t colorCount = 0;
-    if (bitCount <= 8) {
-        colorCount = *reinterpret_cast<const uint32_t*>(data + 32);
-        if (colorCount == 0) {
-            colorCount = 1u << bitCount;
-        }
-        paletteSize = colorCount * 4;
-    }
+    if (outWidth) *outWidth = bitmap.width;
+    if (outHeight) *outHeight = bitmap.height;
 
-    const uint8_t* palette = data + headerSize;
-    const uint8_t* pixels = palette + paletteSize;
+    // Expand straight into the texture; no intermediate surface
+    return createBitmapTexture(renderer_, bitmap, lastError_, nullptr);
+#else
+    return nullptr;
+#endif
+}
 
-    // Calculate row stride (rows are padded to 4-byte boundaries)
-    int rowStride = ((width * bitCount + 31) / 32) * 4;
+SDL_Texture* AssetCache::createTextureFromBMP(const uint8_t* data, size_t size, int& width, int& height,
+                                              LoadTiming* timing) {
+#ifdef SDL_h_
+    BitmapView bitmap;
+    if (parseBitmap(data, size, bitmap)) {
+        SDL_Texture* texture = createBitmapTexture(renderer_, bitmap, lastError_, timing);
+        if (texture) {
+            width = bitmap.width;
+            height = bitmap.height;
+        }
+        return texture;
+    }
 
-    // Create SDL surface
-    SDL_Surface* surface = SDL_CreateRGBSurface(0, width, height, 32,
-        0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+    // RLE, 16 bpp and OS/2 bitmaps go through an SDL surface
+    StageTimer convertTimer(timing, LoadStage::Convert);
+    SDL_Surface* surface = SDL_LoadBMP_RW(SDL_RWFromConstMem(data, static_cast<int>(size)), 1);
+    convertTimer.stop();
     if (!surface) {
-        lastError_ = "Failed to create surface";
+        lastError_ = "Failed to load BMP: " + std::string(SDL_GetError());
         return nullptr;
     }
 
-    // Convert pixel data
-    uint32_t* destPixels = static_cast<uint32_t*>(surface->pixels);
-
-    for (int y = 0; y < height; ++y) {
-        int srcY = topDown ? y : (height - 1 - y);
-        const uint8_t* srcRow = pixels + srcY * rowStride;
-
-        for (int x = 0; x < width; ++x) {
-            uint8_t r, g, b;
-
-            if (bitCount == 8) {
-                uint8_t index = srcRow[x];
-                if (index < colorCount) {
-                    b = palette[index * 4 + 0];
-                    g = palette[index * 4 + 1];
-                    r = palette[index * 4 + 2];
-                } else {
-                    r = g = b = 0;
-                }
-            } else if (bitCount == 4) {
-                uint8_t byte = srcRow[x / 2];
-                uint8_t index = (x % 2 == 0) ? (byte >> 4) : (byte & 0x0F);
-                if (index < colorCount) {
-                    b = palette[index * 4 + 0];
-                    g = palette[index * 4 + 1];
-                    r = palette[index * 4 + 2];
-                } else {
-                    r = g = b = 0;
-                }
-            } else if (bitCount == 1) {
-                uint8_t byte = srcRow[x / 8];
-                uint8_t bit = (byte >> (7 - (x % 8))) & 1;
-                if (bit < colorCount) {
-                    b = palette[bit * 4 + 0];
-                    g = palette[bit * 4 + 1];
-                    r = palette[bit * 4 + 2];
-                } else {
-                    r = g = b = 0;
-                }
-            } else if (bitCount == 24) {
-                b = srcRow[x * 3 + 0];
-                g = srcRow[x * 3 + 1];
-                r = srcRow[x * 3 + 2];
-            } else if (bitCount == 32) {
-                b = srcRow[x * 4 + 0];
-                g = srcRow[x * 4 + 1];
-                r = srcRow[x * 4 + 2];
-            } else {
-                r = g = b = 128; // Unsupported format
-            }
-
-            destPixels[y * width + x] = (0xFF << 24) | (r << 16) | (g << 8) | b;
-        }
-    }
-
-    // Create texture from surface
+    StageTimer uploadTimer(timing, LoadStage::Upload);
     SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer_, surface);
+    uploadTimer.stop();
+    if (texture) {
+        width = surface->w;
+        height = surface->h;
+    } else {
+        lastError_ = "Failed to create texture: " + std::string(SDL_GetError());
+    }
     SDL_FreeSurface(surface);
-
     return texture;
 #else
+    (void)data;
+    (void)size;
+    (void)width;
+    (void)height;
+    (void)timing;
+    lastError_ = "SDL2 not available";
     return nullptr;
 #endif
 }
@@ -889,6 +2261,7 @@ SDL_Texture* AssetCache::loadExtractedTexture(const std::string& gameId, const s
     auto it = textures_.find(cacheKey);
     if (it != textures_.end()) {
         it->second.refCount++;
+        touchAsset(AssetType::Texture, cacheKey);
         stats_.cacheHits++;
         if (outWidth) *outWidth = it->second.width;
         if (outHeight) *outHeight = it->second.height;
@@ -896,94 +2269,130 @@ SDL_Texture* AssetCache::loadExtractedTexture(const std::string& gameId, const s
     }
 
     stats_.cacheMisses++;
+    LoadTiming timing;
 
-    // Build file path
+    StageTimer resolveTimer(&timing, LoadStage::Resolve);
     std::string basePath = extractedBasePath_.empty() ? gamePath_ : extractedBasePath_;
-    std::string filePath = basePath + "/" + gameId + "/sprites/" + spriteName;
-
-    // Try with .bmp extension if not already present
-    if (!fs::exists(filePath)) {
-        filePath += ".bmp";
-    }
-    if (!fs::exists(filePath)) {
-        // Try without extension variations
-        std::string dir = basePath + "/" + gameId + "/sprites/";
-        if (fs::exists(dir)) {
-            for (const auto& entry : fs::directory_iterator(dir)) {
-                std::string fname = entry.path().stem().string();
-                if (fname == spriteName) {
-                    filePath = entry.path().string();
-                    break;
-                }
-            }
-        }
+    std::string filePath = findExtractedSprite(basePath, gameId, spriteName);
+    resolveTimer.stop();
+    if (filePath.empty()) {
+        lastError_ = "Extracted sprite not found: " + basePath + "/" + gameId + "/sprites/" + spriteName;
+        return nullptr;
     }
 
-    if (!fs::exists(filePath)) {
-        lastError_ = "Extracted sprite not found: " + filePath;
+    StageTimer readTimer(&timing, LoadStage::Read);
+    MappedFile file;
+    if (!file.open(filePath)) {
+        lastError_ = "Failed to open " + filePath + ": " + file.getLastError();
         return nullptr;
     }
 
-    // Load BMP directly via SDL
-    SDL_Surface* surface = SDL_LoadBMP(filePath.c_str());
-    if (!surface) {
-        lastError_ = "Failed to load BMP: " + std::string(SDL_GetError());
-        return nullptr;
+    // The same sprite is often extracted for several games
+    uint64_t content = contentKey(file.data(), file.size());
+    timing.bytesFromDisk = file.size();
+    readTimer.stop();
+    if (SDL_Texture* shared = useSharedTexture(cacheKey, content, 1)) {
+        if (outWidth) *outWidth = textures_[cacheKey].width;
+        if (outHeight) *outHeight = textures_[cacheKey].height;
+        recordLoad(AssetType::Texture, cacheKey, timing);
+        return shared;
     }
 
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer_, surface);
-    if (!texture) {
-        lastError_ = "Failed to create texture: " + std::string(SDL_GetError());
-        SDL_FreeSurface(surface);
+    CachedTexture ct;
+    ct.texture = createTextureFromBMP(file.data(), file.size(), ct.width, ct.height, &timing);
+    if (!ct.texture) {
         return nullptr;
     }
+    SDL_Texture* texture = ct.texture;
 
     // Cache
-    CachedTexture ct;
-    ct.texture = texture;
-    ct.width = surface->w;
-    ct.height = surface->h;
     ct.refCount = 1;
     textures_[cacheKey] = ct;
+    addShared(AssetType::Texture, cacheKey, content, {texture, ct.width, ct.height, textureBytes(ct)});
+    trackAsset(AssetType::Texture, cacheKey, textureBytes(ct));
 
-    if (outWidth) *outWidth = surface->w;
-    if (outHeight) *outHeight = surface->h;
+    if (outWidth) *outWidth = ct.width;
+    if (outHeight) *outHeight = ct.height;
 
-    SDL_FreeSurface(surface);
     stats_.texturesLoaded++;
+    recordLoad(AssetType::Texture, cacheKey, timing);
     return texture;
 #else
     return nullptr;
 #endif
 }
 
+void AssetCache::releaseExtractedTexture(const std::string& gameId, const std::string& spriteName) {
+    releaseTexture("extracted:" + gameId + ":sprite:" + spriteName);
+}
+
+std::string AssetCache::findExtractedSprite(const std::string& basePath, const std::string& gameId,
+                                            const std::string& spriteName) const {
+    std::string dir = basePath + "/" + gameId + "/sprites";
+
+    // Exact name, then with .bmp added, then any extension
+    std::string filePath = dirIndex_->find(dir, spriteName);
+    if (filePath.empty()) {
+        filePath = dirIndex_->find(dir, spriteName + ".bmp");
+    }
+    if (filePath.empty()) {
+        filePath = dirIndex_->findStem(dir, spriteName);
+    }
+    return filePath;
+}
+
 Mix_Chunk* AssetCache::loadExtractedSound(const std::string& gameId, const std::string& soundName) {
 #ifdef SDL_h_
     std::string cacheKey = "extracted:" + gameId + ":wav:" + soundName;
 
     auto it = sounds_.find(cacheKey);
     if (it != sounds_.end()) {
+        touchAsset(AssetType::Sound, cacheKey);
         stats_.cacheHits++;
         return it->second;
     }
 
     stats_.cacheMisses++;
+    LoadTiming timing;
 
+    StageTimer resolveTimer(&timing, LoadStage::Resolve);
     std::string basePath = extractedBasePath_.empty() ? gamePath_ : extractedBasePath_;
-    std::string filePath = basePath + "/" + gameId + "/audio/wav/" + soundName;
+    std::string dir = basePath + "/" + gameId + "/audio/wav";
 
-    if (!fs::exists(filePath)) {
-        filePath += ".wav";
+    std::string filePath = dirIndex_->find(dir, soundName);
+    if (filePath.empty()) {
+        filePath = dirIndex_->find(dir, soundName + ".wav");
+    }
+    resolveTimer.stop();
+    if (filePath.empty()) {
+        lastError_ = "Extracted sound not found: " + dir + "/" + soundName;
+        return nullptr;
     }
-    if (!fs::exists(filePath)) {
-        lastError_ = "Extracted sound not found: " + filePath;
+
+    StageTimer readTimer(&timing, LoadStage::Read);
+    MappedFile file;
+    if (!file.open(filePath)) {
+        lastError_ = "Failed to open " + filePath + ": " + file.getLastError();
         return nullptr;
     }
 
-    Mix_Chunk* chunk = Mix_LoadWAV(filePath.c_str());
+    uint64_t content = contentKey(file.data(), file.size());
+    timing.bytesFromDisk = file.size();
+    readTimer.stop();
+    if (Mix_Chunk* shared = useSharedSound(cacheKey, content)) {
+        recordLoad(AssetType::Sound, cacheKey, timing);
+        return shared;
+    }
+
+    StageTimer convertTimer(&timing, LoadStage::Convert);
+    Mix_Chunk* chunk = Mix_LoadWAV_RW(SDL_RWFromConstMem(file.data(), static_cast<int>(file.size())), 1);
+    convertTimer.stop();
     if (chunk) {
         sounds_[cacheKey] = chunk;
+        addShared(AssetType::Sound, cacheKey, content, {chunk, 0, 0, chunk->alen});
+        trackAsset(AssetType::Sound, cacheKey, chunk->alen);
         stats_.soundsLoaded++;
+        recordLoad(AssetType::Sound, cacheKey, timing);
     } else {
         lastError_ = "Failed to load WAV: " + std::string(Mix_GetError());
     }
@@ -999,26 +2408,37 @@ Mix_Music* AssetCache::loadExtractedMusic(const std::string& gameId, const std::
 
     auto it = music_.find(cacheKey);
     if (it != music_.end()) {
+        touchAsset(AssetType::Music, cacheKey);
         stats_.cacheHits++;
         return it->second;
     }
 
     stats_.cacheMisses++;
+    LoadTiming timing;
 
+    StageTimer resolveTimer(&timing, LoadStage::Resolve);
     std::string basePath = extractedBasePath_.empty() ? gamePath_ : extractedBasePath_;
-    std::string filePath = basePath + "/" + gameId + "/audio/midi/" + midiName;
+    std::string dir = basePath + "/" + gameId + "/audio/midi";
 
-    if (!fs::exists(filePath)) {
-        filePath += ".mid";
+    std::string filePath = dirIndex_->find(dir, midiName);
+    if (filePath.empty()) {
+        filePath = dirIndex_->find(dir, midiName + ".mid");
     }
-    if (!fs::exists(filePath)) {
-        lastError_ = "Extracted MIDI not found: " + filePath;
+    resolveTimer.stop();
+    if (filePath.empty()) {
+        lastError_ = "Extracted MIDI not found: " + dir + "/" + midiName;
         return nullptr;
     }
 
+    StageTimer readTimer(&timing, LoadStage::Read);
     Mix_Music* mus = Mix_LoadMUS(filePath.c_str());
+    readTimer.stop();
     if (mus) {
+        size_t bytes = fileBytes(filePath);
         music_[cacheKey] = mus;
+        trackAsset(AssetType::Music, cacheKey, bytes);
+        timing.bytesFromDisk = bytes;
+        recordLoad(AssetType::Music, cacheKey, timing);
     } else {
         lastError_ = "Failed to load MIDI: " + std::string(Mix_GetError());
     }
@@ -1028,9 +2448,86 @@ Mix_Music* AssetCache::loadExtractedMusic(const std::string& gameId, const std::
 #endif
 }
 
-std::vector<std::string> AssetCache::listExtractedAssets(const std::string& gameId, const std::string& category) {
-    std::vector<std::string> result;
+size_t AssetCache::buildAtlas(const std::string& atlasName, const std::string& gameId,
+                              const std::vector<std::string>& spriteNames) {
+#ifdef SDL_h_
+    if (!renderer_) {
+        lastError_ = "No renderer set";
+        return 0;
+    }
+
+    auto& atlas = atlases_[atlasName];
+    if (!atlas) {
+        atlas = std::make_unique<TextureAtlas>(renderer_);
+    }
+
+    // Decode every BMP in parallel
+    std::string basePath = extractedBasePath_.empty() ? gamePath_ : extractedBasePath_;
+    std::vector<SDL_Surface*> surfaces(spriteNames.size(), nullptr);
+    if (!loadPool_) {
+        loadPool_ = std::make_unique<JobPool>(workerCount_);
+    }
+    for (size_t i = 0; i < spriteNames.size(); ++i) {
+        loadPool_->submit([this, &basePath, &gameId, &spriteNames, &surfaces, i]() {
+            std::string filePath = findExtractedSprite(basePath, gameId, spriteNames[i]);
+            if (!filePath.empty()) {
+                surfaces[i] = SDL_LoadBMP(filePath.c_str());
+            }
+        });
+    }
+    loadPool_->waitIdle();
+
+    // Tallest first packs tightest on a skyline
+    std::vector<size_t> order;
+    for (size_t i = 0; i < surfaces.size(); ++i) {
+        if (surfaces[i]) {
+            order.push_back(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&surfaces](size_t a, size_t b) {
+        return surfaces[a]->h > surfaces[b]->h;
+    });
+
+    for (size_t i : order) {
+        std::string cacheKey = "extracted:" + gameId + ":sprite:" + spriteNames[i];
+        if (!atlas->add(cacheKey, surfaces[i])) {
+            lastError_ = atlas->getLastError();
+        }
+    }
+
+    for (SDL_Surface* surface : surfaces) {
+        if (surface) {
+            SDL_FreeSurface(surface);
+        }
+    }
+
+    return atlas->getSpriteCount();
+#else
+    (void)atlasName;
+    (void)gameId;
+    (void)spriteNames;
+    lastError_ = "SDL2 not available";
+    return 0;
+#endif
+}
+
+bool AssetCache::getAtlasRegion(const std::string& gameId, const std::string& spriteName,
+                                AtlasRegion& out) const {
+    std::string cacheKey = "extracted:" + gameId + ":sprite:" + spriteName;
+    for (const auto& pair : atlases_) {
+        if (const AtlasRegion* region = pair.second->find(cacheKey)) {
+            out = *region;
+            return true;
+        }
+    }
+    return false;
+}
+
+void AssetCache::releaseAtlas(const std::string& atlasName) {
+    atlases_.erase(atlasName);
+}
 
+std::vector<std::string> AssetCache::listExtractedAssets(const std::string& gameId, const std::string& category) {
     std::string basePath = extractedBasePath_.empty() ? gamePath_ : extractedBasePath_;
     std::string dirPath;
 
@@ -1050,18 +2547,7 @@ std::vector<std::string> AssetCache::listExtractedAssets(const std::string& game
         dirPath = basePath + "/" + gameId + "/" + category;
     }
 
-    if (!fs::exists(dirPath) || !fs::is_directory(dirPath)) {
-        return result;
-    }
-
-    for (const auto& entry : fs::directory_iterator(dirPath)) {
-        if (entry.is_regular_file()) {
-            result.push_back(entry.path().filename().string());
-        }
-    }
-
-    std::sort(result.begin(), result.end());
-    return result;
+    return dirIndex_->list(dirPath);
 }
 
 } // namespace opengg
@@ -0,0 +1,533 @@
+#include "cache_pack.h"
+#include "mapped_file.h"
+#include "crc32.h"
+#include <filesystem>
+#include <algorithm>
+#include <string_view>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+#include <ctime>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace opengg {
+
+static constexpr char PACK_MAGIC[4] = {'O', 'G', 'C', 'P'};
+static constexpr uint32_t PACK_VERSION = 1;
+
+// Both header slots come first; blobs start right after them
+static constexpr uint64_t kDataStart = 2 * sizeof(CachePackHeader);
+static constexpr uint64_t kBlobAlignment = 16;
+
+// Pending writes are committed once either limit is reached
+static constexpr size_t kCommitBytes = 4 * 1024 * 1024;
+static constexpr size_t kCommitCount = 256;
+
+// Compact once dead space exceeds both this and the live data
+static constexpr uint64_t kCompactMinWaste = 1024 * 1024;
+
+static uint64_t alignUp(uint64_t value) {
+    return (value + kBlobAlignment - 1) & ~(kBlobAlignment - 1);
+}
+
+static bool seekTo(FILE* file, uint64_t offset) {
+#ifdef _WIN32
+    return _fseeki64(file, static_cast<int64_t>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+// Flush stdio buffers and force the data to disk, so later writes can't
+// land before it
+static bool syncFile(FILE* file) {
+    if (std::fflush(file) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+static uint32_t headerCRC(const CachePackHeader& header) {
+    return crc32(reinterpret_cast<const uint8_t*>(&header), offsetof(CachePackHeader, headerCRC));
+}
+
+CachePack::CachePack()
+    : mapping_(std::make_unique<MappedFile>()) {
+}
+
+CachePack::~CachePack() {
+    close();
+}
+
+bool CachePack::open(const std::string& path) {
+    close();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    path_ = path;
+
+    std::error_code ec;
+    if (!fs::exists(path, ec) && !createEmpty()) {
+        return false;
+    }
+
+    // An unreadable pack is only a cache; start over
+    if (!loadIndex() && (!createEmpty() || !loadIndex())) {
+        return false;
+    }
+
+    isOpen_ = true;
+    return true;
+}
+
+void CachePack::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (isOpen_) {
+        commitLocked();
+    }
+
+    mapping_->close();
+    entries_ = nullptr;
+    strings_ = nullptr;
+    header_ = {};
+    pending_.clear();
+    pendingBytes_ = 0;
+    isOpen_ = false;
+}
+
+bool CachePack::createEmpty() {
+    mapping_->close();
+    entries_ = nullptr;
+    strings_ = nullptr;
+    header_ = {};
+    return writePack(path_, true);
+}
+
+bool CachePack::loadIndex() {
+    entries_ = nullptr;
+    strings_ = nullptr;
+    header_ = {};
+
+    if (!mapping_->open(path_)) {
+        lastError_ = mapping_->getLastError();
+        return false;
+    }
+
+    const uint8_t* data = mapping_->data();
+    uint64_t fileSize = mapping_->size();
+    if (fileSize < kDataStart) {
+        lastError_ = "Cache pack is truncated: " + path_;
+        return false;
+    }
+
+    // Pick the newest slot that is complete and consistent
+    int best = -1;
+    for (int slot = 0; slot < 2; ++slot) {
+        CachePackHeader header;
+        std::memcpy(&header, data + slot * sizeof(CachePackHeader), sizeof(header));
+
+        if (std::memcmp(header.magic, PACK_MAGIC, 4) != 0 || header.version != PACK_VERSION ||
+            header.headerCRC != headerCRC(header)) {
+            continue;
+        }
+
+        uint64_t indexBytes = static_cast<uint64_t>(header.indexCount) * sizeof(CachePackEntry) +
+                              header.stringPoolSize;
+        if (header.dataEnd > fileSize || header.indexOffset < kDataStart ||
+            header.indexOffset > header.dataEnd || indexBytes > header.dataEnd - header.indexOffset) {
+            continue;
+        }
+        if (crc32(data + header.indexOffset, static_cast<size_t>(indexBytes)) != header.indexCRC) {
+            continue;
+        }
+
+        if (best < 0 || header.sequence > header_.sequence) {
+            header_ = header;
+            best = slot;
+        }
+    }
+
+    if (best < 0) {
+        header_ = {};
+        lastError_ = "Cache pack has no valid header: " + path_;
+        return false;
+    }
+    headerSlot_ = best;
+
+    const auto* entries = reinterpret_cast<const CachePackEntry*>(data + header_.indexOffset);
+    for (uint32_t i = 0; i < header_.indexCount; ++i) {
+        const CachePackEntry& entry = entries[i];
+        if (entry.offset < kDataStart || entry.offset > header_.indexOffset ||
+            entry.size > header_.indexOffset - entry.offset ||
+            entry.idOffset > header_.stringPoolSize ||
+            entry.idLength > header_.stringPoolSize - entry.idOffset) {
+            header_ = {};
+            lastError_ = "Cache pack index is corrupt: " + path_;
+            return false;
+        }
+    }
+
+    entries_ = entries;
+    strings_ = reinterpret_cast<const char*>(data + header_.indexOffset) +
+               static_cast<size_t>(header_.indexCount) * sizeof(CachePackEntry);
+    return true;
+}
+
+std::string CachePack::getEntryId(const CachePackEntry& entry) const {
+    return std::string(strings_ + entry.idOffset, entry.idLength);
+}
+
+const CachePackEntry* CachePack::findEntry(const std::string& id) const {
+    if (!entries_) {
+        return nullptr;
+    }
+
+    auto idOf = [this](const CachePackEntry& entry) {
+        return std::string_view(strings_ + entry.idOffset, entry.idLength);
+    };
+
+    const CachePackEntry* end = entries_ + header_.indexCount;
+    const CachePackEntry* it = std::lower_bound(entries_, end, id,
+        [&](const CachePackEntry& entry, const std::string& key) { return idOf(entry) < key; });
+    if (it == end || idOf(*it) != id) {
+        return nullptr;
+    }
+    return it;
+}
+
+bool CachePack::contains(const std::string& id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pending_.find(id);
+    if (it != pending_.end()) {
+        return !it->second.removed;
+    }
+    return findEntry(id) != nullptr;
+}
+
+bool CachePack::read(const std::string& id, std::vector<uint8_t>& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = pending_.find(id);
+    if (it != pending_.end()) {
+        out = it->second.data;
+        return !it->second.removed;
+    }
+
+    const CachePackEntry* entry = findEntry(id);
+    if (!entry) {
+        return false;
+    }
+
+    const uint8_t* blob = mapping_->at(entry->offset, entry->size);
+    if (!blob) {
+        return false;
+    }
+    out.assign(blob, blob + entry->size);
+    return true;
+}
+
+bool CachePack::write(const std::string& id, const uint8_t* data, size_t size, uint32_t tag) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!isOpen_) {
+        lastError_ = "Cache pack is not open";
+        return false;
+    }
+    if (size > UINT32_MAX) {
+        lastError_ = "Blob too large for cache pack: " + id;
+        return false;
+    }
+
+    PendingBlob& blob = pending_[id];
+    pendingBytes_ -= blob.data.size();
+    blob.data.assign(data, data + size);
+    blob.tag = tag;
+    blob.crc32 = crc32(data, size);
+    blob.timestamp = static_cast<uint64_t>(std::time(nullptr));
+    blob.removed = false;
+    pendingBytes_ += size;
+
+    if (pendingBytes_ >= kCommitBytes || pending_.size() >= kCommitCount) {
+        return commitLocked();
+    }
+    return true;
+}
+
+void CachePack::remove(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = pending_.find(id);
+    if (it != pending_.end()) {
+        pendingBytes_ -= it->second.data.size();
+        pending_.erase(it);
+    }
+
+    // Committed blobs need a tombstone until the next commit
+    if (findEntry(id)) {
+        pending_[id].removed = true;
+    }
+}
+
+bool CachePack::commit() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return commitLocked();
+}
+
+bool CachePack::commitLocked() {
+    if (!isOpen_ || pending_.empty()) {
+        return true;
+    }
+
+    bool written = writePack(path_, false);
+
+    // Remap whichever header is now current; on failure that is still the
+    // previous one and the pending blobs stay queued
+    if (!loadIndex()) {
+        isOpen_ = false;
+        return false;
+    }
+    if (!written) {
+        return false;
+    }
+
+    pending_.clear();
+    pendingBytes_ = 0;
+
+    uint64_t waste = header_.dataEnd - kDataStart - header_.liveBytes;
+    if (waste > kCompactMinWaste && waste > header_.liveBytes) {
+        return compactLocked();
+    }
+    return true;
+}
+
+bool CachePack::compact() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return isOpen_ && compactLocked();
+}
+
+bool CachePack::compactLocked() {
+    std::string tempPath = path_ + ".tmp";
+    if (!writePack(tempPath, true)) {
+        std::error_code ec;
+        fs::remove(tempPath, ec);
+        return false;
+    }
+
+    // The mapping must go before the file can be replaced on Windows
+    mapping_->close();
+    std::error_code ec;
+    fs::rename(tempPath, path_, ec);
+    if (ec) {
+        lastError_ = "Failed to replace cache pack: " + ec.message();
+    }
+
+    if (!loadIndex()) {
+        isOpen_ = false;
+        return false;
+    }
+    if (ec) {
+        return false;
+    }
+
+    pending_.clear();
+    pendingBytes_ = 0;
+    return true;
+}
+
+bool CachePack::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.clear();
+    pendingBytes_ = 0;
+
+    isOpen_ = createEmpty() && loadIndex();
+    return isOpen_;
+}
+
+// Write the merged index (committed entries overridden by pending blobs).
+// Appending places new blobs and the index after the committed data and
+// then switches to the spare header slot; a rewrite produces a fresh file
+// holding only live blobs.
+bool CachePack::writePack(const std::string& path, bool rewrite) {
+    struct Item {
+        std::string id;
+        CachePackEntry entry;
+        const uint8_t* data;    // nullptr: committed blob stays where it is
+    };
+
+    std::vector<Item> items;
+    items.reserve(header_.indexCount + pending_.size());
+
+    for (uint32_t i = 0; i < header_.indexCount; ++i) {
+        const CachePackEntry& entry = entries_[i];
+        std::string id = getEntryId(entry);
+        if (pending_.count(id)) {
+            continue;
+        }
+        const uint8_t* data = rewrite ? mapping_->data() + entry.offset : nullptr;
+        items.push_back({std::move(id), entry, data});
+    }
+
+    for (const auto& pair : pending_) {
+        if (pair.second.removed) {
+            continue;
+        }
+        CachePackEntry entry{};
+        entry.size = static_cast<uint32_t>(pair.second.data.size());
+        entry.tag = pair.second.tag;
+        entry.crc32 = pair.second.crc32;
+        entry.timestamp = pair.second.timestamp;
+        items.push_back({pair.first, entry, pair.second.data.data()});
+    }
+
+    std::sort(items.begin(), items.end(),
+              [](const Item& a, const Item& b) { return a.id < b.id; });
+
+    // Appending writes into the mapped file itself
+    if (!rewrite) {
+        mapping_->close();
+    }
+
+    FILE* file = std::fopen(path.c_str(), rewrite ? "wb" : "r+b");
+    if (!file) {
+        lastError_ = "Failed to open cache pack for writing: " + path;
+        return false;
+    }
+
+    bool ok = true;
+    CachePackHeader emptySlots[2] = {};
+    if (rewrite) {
+        ok = std::fwrite(emptySlots, sizeof(emptySlots), 1, file) == 1;
+    }
+
+    // Blobs
+    uint64_t pos = rewrite ? kDataStart : header_.dataEnd;
+    uint64_t liveBytes = 0;
+    for (auto& item : items) {
+        if (ok && item.data) {
+            pos = alignUp(pos);
+            ok = seekTo(file, pos) &&
+                 (item.entry.size == 0 || std::fwrite(item.data, item.entry.size, 1, file) == 1);
+            item.entry.offset = pos;
+            pos += item.entry.size;
+        }
+        liveBytes += item.entry.size;
+    }
+
+    // Index: entries in ID order, then the string pool
+    std::vector<CachePackEntry> entries;
+    std::vector<char> strings;
+    entries.reserve(items.size());
+    for (auto& item : items) {
+        item.entry.idOffset = static_cast<uint32_t>(strings.size());
+        item.entry.idLength = static_cast<uint32_t>(item.id.size());
+        strings.insert(strings.end(), item.id.begin(), item.id.end());
+        entries.push_back(item.entry);
+    }
+
+    CachePackHeader header{};
+    std::memcpy(header.magic, PACK_MAGIC, 4);
+    header.version = PACK_VERSION;
+    header.sequence = header_.sequence + 1;
+    header.indexOffset = alignUp(pos);
+    header.indexCount = static_cast<uint32_t>(entries.size());
+    header.stringPoolSize = static_cast<uint32_t>(strings.size());
+    header.liveBytes = liveBytes;
+
+    size_t entryBytes = entries.size() * sizeof(CachePackEntry);
+    header.indexCRC = crc32(reinterpret_cast<const uint8_t*>(entries.data()), entryBytes);
+    header.indexCRC = crc32(reinterpret_cast<const uint8_t*>(strings.data()), strings.size(),
+                            header.indexCRC);
+    header.dataEnd = header.indexOffset + entryBytes + strings.size();
+    header.headerCRC = headerCRC(header);
+
+    ok = ok && seekTo(file, header.indexOffset) &&
+         (entries.empty() || std::fwrite(entries.data(), entryBytes, 1, file) == 1) &&
+         (strings.empty() || std::fwrite(strings.data(), strings.size(), 1, file) == 1);
+
+    // Everything the header points at must be on disk before the header is
+    ok = ok && syncFile(file);
+
+    int slot = rewrite ? 0 : 1 - headerSlot_;
+    ok = ok && seekTo(file, slot * sizeof(CachePackHeader)) &&
+         std::fwrite(&header, sizeof(header), 1, file) == 1 && syncFile(file);
+
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) {
+        lastError_ = "Failed to write cache pack: " + path;
+    }
+    return ok;
+}
+
+std::vector<CachePackInfo> CachePack::list(const std::string& prefix) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::vector<CachePackInfo> result;
+
+    if (entries_) {
+        auto idOf = [this](const CachePackEntry& entry) {
+            return std::string_view(strings_ + entry.idOffset, entry.idLength);
+        };
+
+        // IDs sharing a prefix are contiguous in the sorted index
+        const CachePackEntry* end = entries_ + header_.indexCount;
+        const CachePackEntry* it = std::lower_bound(entries_, end, prefix,
+            [&](const CachePackEntry& entry, const std::string& key) { return idOf(entry) < key; });
+        for (; it != end && idOf(*it).substr(0, prefix.size()) == prefix; ++it) {
+            std::string id = getEntryId(*it);
+            if (!pending_.count(id)) {
+                result.push_back({std::move(id), it->tag, it->size, it->crc32, it->timestamp,
+                                  it->offset});
+            }
+        }
+    }
+
+    for (const auto& pair : pending_) {
+        const PendingBlob& blob = pair.second;
+        if (blob.removed || pair.first.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        result.push_back({pair.first, blob.tag, static_cast<uint32_t>(blob.data.size()),
+                          blob.crc32, blob.timestamp, UINT64_MAX});
+    }
+    return result;
+}
+
+size_t CachePack::getEntryCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = header_.indexCount;
+    for (const auto& pair : pending_) {
+        bool committed = findEntry(pair.first) != nullptr;
+        if (pair.second.removed) {
+            count -= committed ? 1 : 0;
+        } else if (!committed) {
+            count++;
+        }
+    }
+    return count;
+}
+
+uint64_t CachePack::getFileSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return mapping_->size();
+}
+
+uint64_t CachePack::getLiveBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return header_.liveBytes;
+}
+
+std::string CachePack::getLastError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lastError_;
+}
+
+} // namespace opengg
@@ -0,0 +1,171 @@
+#include "crc32.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define OPENGG_CRC32_PCLMUL 1
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace opengg {
+
+// Slice-by-8 lookup tables (built on first use, thread-safe static init)
+// entries[0] is the classic byte table; entries[k][i] is the CRC of byte i
+// followed by k zero bytes, so eight bytes can be folded per step
+struct CRC32Table {
+    uint32_t entries[8][256];
+
+    CRC32Table() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int j = 0; j < 8; ++j) {
+                crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+            }
+            entries[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (int k = 1; k < 8; ++k) {
+                uint32_t prev = entries[k - 1][i];
+                entries[k][i] = entries[0][prev & 0xFF] ^ (prev >> 8);
+            }
+        }
+    }
+};
+
+static const CRC32Table& getCRC32Table() {
+    static const CRC32Table table;
+    return table;
+}
+
+// Portable path; works on the inverted CRC register (little-endian loads)
+static uint32_t crc32SliceBy8(const uint8_t* data, size_t size, uint32_t crc) {
+    const auto& t = getCRC32Table().entries;
+
+    while (size >= 8) {
+        uint32_t lo, hi;
+        std::memcpy(&lo, data, 4);
+        std::memcpy(&hi, data + 4, 4);
+        lo ^= crc;
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        data += 8;
+        size -= 8;
+    }
+
+    while (size--) {
+        crc = t[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#ifdef OPENGG_CRC32_PCLMUL
+
+static bool hasPCLMUL() {
+    static const bool supported = [] {
+#ifdef _MSC_VER
+        int regs[4];
+        __cpuid(regs, 1);
+        return (regs[2] & (1 << 1)) != 0;
+#else
+        unsigned int eax, ebx, ecx, edx;
+        return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_PCLMUL) != 0;
+#endif
+    }();
+    return supported;
+}
+
+#ifdef _MSC_VER
+#define TARGET_PCLMUL
+#else
+#define TARGET_PCLMUL __attribute__((target("pclmul,sse2")))
+#endif
+
+TARGET_PCLMUL static inline __m128i loadBlock(const uint8_t* p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+// x * k folded onto the next 128-bit block
+TARGET_PCLMUL static inline __m128i foldBlock(__m128i x, __m128i k, __m128i next) {
+    __m128i lo = _mm_clmulepi64_si128(x, k, 0x00);
+    __m128i hi = _mm_clmulepi64_si128(x, k, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(hi, lo), next);
+}
+
+// Carry-less multiply folding ("Fast CRC Computation for Generic Polynomials
+// Using PCLMULQDQ", Intel 2009), bit-reflected constants for 0xEDB88320.
+// Works on the inverted CRC register; size must be >= 64 and a multiple of 16.
+TARGET_PCLMUL static uint32_t crc32PCLMUL(const uint8_t* data, size_t size, uint32_t crc) {
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    __m128i x1 = _mm_xor_si128(loadBlock(data), _mm_cvtsi32_si128(static_cast<int>(crc)));
+    __m128i x2 = loadBlock(data + 16);
+    __m128i x3 = loadBlock(data + 32);
+    __m128i x4 = loadBlock(data + 48);
+    data += 64;
+    size -= 64;
+
+    // Four lanes folded 64 bytes at a time
+    while (size >= 64) {
+        x1 = foldBlock(x1, k1k2, loadBlock(data));
+        x2 = foldBlock(x2, k1k2, loadBlock(data + 16));
+        x3 = foldBlock(x3, k1k2, loadBlock(data + 32));
+        x4 = foldBlock(x4, k1k2, loadBlock(data + 48));
+        data += 64;
+        size -= 64;
+    }
+
+    // Merge the lanes, then fold any remaining 16-byte blocks
+    x1 = foldBlock(x1, k3k4, x2);
+    x1 = foldBlock(x1, k3k4, x3);
+    x1 = foldBlock(x1, k3k4, x4);
+    while (size >= 16) {
+        x1 = foldBlock(x1, k3k4, loadBlock(data));
+        data += 16;
+        size -= 16;
+    }
+
+    // 128 -> 64 bits
+    __m128i t = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), t);
+    t = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, t);
+
+    // Barrett reduction to 32 bits
+    t = _mm_and_si128(x1, mask32);
+    t = _mm_clmulepi64_si128(t, poly, 0x10);
+    t = _mm_and_si128(t, mask32);
+    t = _mm_clmulepi64_si128(t, poly, 0x00);
+    x1 = _mm_xor_si128(x1, t);
+
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(x1, 4)));
+}
+
+#endif // OPENGG_CRC32_PCLMUL
+
+uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc) {
+    crc = ~crc;
+
+#ifdef OPENGG_CRC32_PCLMUL
+    if (size >= 64 && hasPCLMUL()) {
+        size_t blocks = size & ~static_cast<size_t>(15);
+        crc = crc32PCLMUL(data, blocks, crc);
+        data += blocks;
+        size -= blocks;
+    }
+#endif
+
+    return ~crc32SliceBy8(data, size, crc);
+}
+
+} // namespace opengg
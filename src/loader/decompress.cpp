@@ -0,0 +1,313 @@
+#include "decompress.h"
+#include <cstring>
+#include <algorithm>
+
+namespace opengg {
+
+// Copy a literal span. Sprite literals are mostly short, so small spans use
+// two overlapping fixed-size moves (lowered to single SSE2/NEON or 64-bit
+// loads and stores) instead of a memcpy call or a byte loop.
+static inline void copySpan(uint8_t* dst, const uint8_t* src, size_t n) {
+    if (n >= 16) {
+        if (n <= 32) {
+            std::memcpy(dst, src, 16);
+            std::memcpy(dst + n - 16, src + n - 16, 16);
+        } else {
+            std::memcpy(dst, src, n);
+        }
+    } else if (n >= 8) {
+        std::memcpy(dst, src, 8);
+        std::memcpy(dst + n - 8, src + n - 8, 8);
+    } else if (n >= 4) {
+        std::memcpy(dst, src, 4);
+        std::memcpy(dst + n - 4, src + n - 4, 4);
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = src[i];
+        }
+    }
+}
+
+// Fill a run with one byte value, using the same overlapping-store trick
+static inline void fillSpan(uint8_t* dst, uint8_t value, size_t n) {
+    if (n >= 16) {
+        std::memset(dst, value, n);
+    } else if (n >= 8) {
+        uint64_t pattern = value * 0x0101010101010101ULL;
+        std::memcpy(dst, &pattern, 8);
+        std::memcpy(dst + n - 8, &pattern, 8);
+    } else if (n >= 4) {
+        uint32_t pattern = value * 0x01010101u;
+        std::memcpy(dst, &pattern, 4);
+        std::memcpy(dst + n - 4, &pattern, 4);
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = value;
+        }
+    }
+}
+
+size_t decodeRLEPackBits(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+    size_t in = 0;
+    size_t out = 0;
+
+    while (in < srcSize && out < dstSize) {
+        uint8_t control = src[in++];
+
+        if (control & 0x80) {
+            // Run of same byte
+            if (in >= srcSize) break;
+            size_t count = std::min<size_t>((control & 0x7F) + 1, dstSize - out);
+            fillSpan(dst + out, src[in++], count);
+            out += count;
+        } else {
+            // Literal bytes
+            size_t count = std::min<size_t>(control + 1, std::min(srcSize - in, dstSize - out));
+            copySpan(dst + out, src + in, count);
+            in += count;
+            out += count;
+        }
+    }
+
+    return out;
+}
+
+size_t decodeRLEEscapeFF(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+    size_t in = 0;
+    size_t out = 0;
+
+    while (in < srcSize && out < dstSize) {
+        // Everything up to the next escape is one literal span; memchr scans
+        // for it with the C library's vectorized search
+        const void* escape = std::memchr(src + in, 0xFF, srcSize - in);
+        size_t literalEnd = escape ? static_cast<size_t>(static_cast<const uint8_t*>(escape) - src)
+                                   : srcSize;
+
+        // An escape too close to the end to hold <byte> <count> is a literal,
+        // and so is anything after it
+        if (literalEnd + 2 >= srcSize) {
+            literalEnd = srcSize;
+        }
+
+        if (literalEnd > in) {
+            size_t count = std::min(literalEnd - in, dstSize - out);
+            copySpan(dst + out, src + in, count);
+            in += count;
+            out += count;
+            continue;
+        }
+
+        // RLE: FF <byte> <count>
+        uint8_t value = src[in + 1];
+        size_t count = src[in + 2];
+        if (count == 0) count = 1;  // Safety
+        count = std::min(count, dstSize - out);
+        fillSpan(dst + out, value, count);
+        out += count;
+        in += 3;
+    }
+
+    return out;
+}
+
+size_t decodeRLERows(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t width, size_t height) {
+    size_t in = 0;
+    size_t x = 0;
+    size_t y = 0;
+
+    while (in < srcSize && y < height) {
+        uint8_t cmd = src[in];
+
+        if (cmd == 0x00) {
+            in++;
+            y++;
+            x = 0;
+            continue;
+        }
+
+        // Output position, clamped so overlong rows write nothing
+        uint8_t* out = dst + y * width + std::min(x, width);
+        size_t room = width - std::min(x, width);
+
+        if (cmd == 0xFF && in + 2 < srcSize) {
+            // FF <byte> <count>
+            fillSpan(out, src[in + 1], std::min<size_t>(src[in + 2] + 1u, room));
+            x += src[in + 2] + 1u;
+            in += 3;
+            continue;
+        }
+
+        // Literal span up to the next row end or escape
+        size_t end = in + 1;
+        while (end < srcSize && src[end] != 0x00 && (src[end] != 0xFF || end + 2 >= srcSize)) {
+            end++;
+        }
+        copySpan(out, src + in, std::min(end - in, room));
+        x += end - in;
+        in = end;
+    }
+
+    // A last row without its terminator still counts
+    return (x > 0 && y < height) ? y + 1 : y;
+}
+
+size_t decodeRLESprite(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+    size_t in = 0;
+    size_t out = 0;
+
+    while (in < srcSize && out < dstSize) {
+        uint8_t cmd = src[in++];
+
+        if (cmd == 0) {
+            // End of line or special
+            if (in >= srcSize) break;
+            uint8_t count = src[in++];
+            if (count == 0) {
+                // End of bitmap
+                break;
+            }
+            // Skip pixels (transparent)
+            out += count;
+        } else if (cmd < 128) {
+            // Literal run
+            size_t count = std::min<size_t>(cmd, std::min(srcSize - in, dstSize - out));
+            copySpan(dst + out, src + in, count);
+            in += count;
+            out += count;
+        } else {
+            // Repeat run
+            if (in >= srcSize) break;
+            size_t count = std::min<size_t>(cmd - 128, dstSize - out);
+            fillSpan(dst + out, src[in++], count);
+            out += count;
+        }
+    }
+
+    return std::min(out, dstSize);
+}
+
+// Longest LZ match
+static constexpr size_t kLZMaxMatch = 18;
+// Every match is copied as three 8-byte words
+static constexpr size_t kLZMatchWrite = 24;
+// Most output one LZ flag group can produce, plus match copy overshoot
+static constexpr size_t kLZGroupOutput = 8 * kLZMaxMatch + kLZMatchWrite;
+// Most input one LZ flag group can consume (flag byte + 8 references),
+// plus the overread of the 8-byte literal copies
+static constexpr size_t kLZGroupInput = 1 + 8 * 2 + 8;
+
+// Number of consecutive set bits from bit 0, i.e. the literal run length
+// at the front of a (shifted) LZ flag byte
+struct LiteralRunTable {
+    uint8_t run[256];
+
+    LiteralRunTable() {
+        for (unsigned flags = 0; flags < 256; ++flags) {
+            uint8_t count = 0;
+            while (count < 8 && (flags & (1u << count))) {
+                ++count;
+            }
+            run[flags] = count;
+        }
+    }
+};
+
+static const LiteralRunTable kLiteralRuns;
+
+// Copy a match whose source lies entirely inside the output. Always writes
+// kLZMatchWrite bytes, so up to 21 bytes past length are overwritten.
+static inline void copyMatch(uint8_t* dst, size_t offset) {
+    const uint8_t* from = dst - offset;
+
+    if (offset >= 8) {
+        // Source is at least a word behind, so each word is complete before
+        // it is read
+        std::memcpy(dst, from, 8);
+        std::memcpy(dst + 8, from + 8, 8);
+        std::memcpy(dst + 16, from + 16, 8);
+    } else {
+        // Short overlapping match: the output repeats with period offset.
+        // Build the first word byte by byte, then store it again at a stride
+        // that is a multiple of the period (5-8 bytes, so 3 words cover 18).
+        static const uint8_t kStride[8] = {0, 8, 8, 6, 8, 5, 6, 7};
+        for (size_t i = 0; i < 8; ++i) {
+            dst[i] = from[i];
+        }
+        uint64_t word;
+        std::memcpy(&word, dst, 8);
+        size_t stride = kStride[offset];
+        std::memcpy(dst + stride, &word, 8);
+        std::memcpy(dst + 2 * stride, &word, 8);
+    }
+}
+
+size_t decodeLZ(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+    size_t in = 0;
+    size_t out = 0;
+
+    // Fast path: whole flag groups with room to spare on both sides, so no
+    // per-item bounds checks are needed
+    while (srcSize - in >= kLZGroupInput && dstSize - out >= kLZGroupOutput) {
+        uint8_t flags = src[in++];
+
+        int bit = 0;
+        while (bit < 8) {
+            unsigned pending = flags >> bit;
+            if (pending & 1) {
+                // Run of literals: one word copy, then advance by the run length
+                size_t run = kLiteralRuns.run[pending];
+                std::memcpy(dst + out, src + in, 8);
+                in += run;
+                out += run;
+                bit += static_cast<int>(run);
+                continue;
+            }
+
+            uint16_t ref = src[in] | (src[in + 1] << 8);
+            in += 2;
+            size_t offset = (ref >> 4) + 1;
+            size_t length = (ref & 0x0F) + 3;
+
+            if (offset <= out) {
+                copyMatch(dst + out, offset);
+            } else {
+                // Reaches before the start of output (only near the beginning)
+                for (size_t j = 0; j < length; ++j) {
+                    dst[out + j] = (out + j >= offset) ? dst[out + j - offset] : 0;
+                }
+            }
+            out += length;
+            ++bit;
+        }
+    }
+
+    // Tail: checked decode of the remaining groups
+    while (in < srcSize && out < dstSize) {
+        uint8_t flags = src[in++];
+
+        for (int bit = 0; bit < 8 && in < srcSize && out < dstSize; ++bit) {
+            if (flags & (1 << bit)) {
+                // Literal byte
+                dst[out++] = src[in++];
+            } else {
+                // Back reference
+                if (in + 1 >= srcSize) break;
+                uint16_t ref = src[in] | (src[in + 1] << 8);
+                in += 2;
+
+                size_t offset = (ref >> 4) + 1;
+                size_t length = std::min<size_t>((ref & 0x0F) + 3, dstSize - out);
+
+                for (size_t j = 0; j < length; ++j) {
+                    // References before the start of the output read as zero
+                    dst[out] = (out >= offset) ? dst[out - offset] : 0;
+                    out++;
+                }
+            }
+        }
+    }
+
+    return out;
+}
+
+} // namespace opengg
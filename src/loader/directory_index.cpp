@@ -0,0 +1,73 @@
+#include "directory_index.h"
+#include <filesystem>
+#include <algorithm>
+#include <cctype>
+
+namespace fs = std::filesystem;
+
+namespace opengg {
+
+std::string toLower(std::string str) {
+    std::transform(str.begin(), str.end(), str.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return str;
+}
+
+const DirectoryIndex::Directory& DirectoryIndex::getDirectory(const std::string& dir) const {
+    auto it = dirs_.find(dir);
+    if (it != dirs_.end()) {
+        return it->second;
+    }
+
+    Directory& entry = dirs_[dir];
+
+    std::error_code ec;
+    for (const auto& file : fs::directory_iterator(dir, ec)) {
+        if (file.is_regular_file(ec)) {
+            entry.names.push_back(file.path().filename().string());
+        }
+    }
+    std::sort(entry.names.begin(), entry.names.end());
+
+    // First in name order wins when names differ only in case
+    for (size_t i = 0; i < entry.names.size(); ++i) {
+        entry.byName.emplace(toLower(entry.names[i]), i);
+        entry.byStem.emplace(toLower(fs::path(entry.names[i]).stem().string()), i);
+    }
+
+    return entry;
+}
+
+std::string DirectoryIndex::find(const std::string& dir, const std::string& filename) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Directory& entry = getDirectory(dir);
+
+    auto it = entry.byName.find(toLower(filename));
+    if (it == entry.byName.end()) {
+        return {};
+    }
+    return dir + "/" + entry.names[it->second];
+}
+
+std::string DirectoryIndex::findStem(const std::string& dir, const std::string& stem) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Directory& entry = getDirectory(dir);
+
+    auto it = entry.byStem.find(toLower(stem));
+    if (it == entry.byStem.end()) {
+        return {};
+    }
+    return dir + "/" + entry.names[it->second];
+}
+
+std::vector<std::string> DirectoryIndex::list(const std::string& dir) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return getDirectory(dir).names;
+}
+
+void DirectoryIndex::refresh() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dirs_.clear();
+}
+
+} // namespace opengg
@@ -1,5 +1,6 @@
 #include "grp_archive.h"
-#include <fstream>
+#include "loader_error.h"
+#include "decompress.h"
 #include <cstring>
 #include <algorithm>
 #include <cctype>
@@ -28,61 +29,71 @@ bool GrpArchive::open(const std::string& path) {
     close();
     filePath_ = path;
 
-    std::ifstream file(path, std::ios::binary);
-    if (!file) {
-        lastError_ = "Failed to open file: " + path;
+    // Map the whole archive once; entries are served straight from the mapping
+    if (!mapping_.open(path)) {
+        lastError_ = mapping_.getLastError();
         return false;
     }
 
     // Read and verify header
-    GrpHeader header;
-    file.read(reinterpret_cast<char*>(&header), sizeof(header));
-    if (!file) {
+    const GrpHeader* header = reinterpret_cast<const GrpHeader*>(
+        mapping_.at(0, sizeof(GrpHeader)));
+    if (!header) {
         lastError_ = "Failed to read GRP header";
+        mapping_.close();
         return false;
     }
 
     // Check magic
-    if (std::memcmp(header.magic, GRP_MAGIC, 4) != 0) {
+    if (std::memcmp(header->magic, GRP_MAGIC, 4) != 0) {
         lastError_ = "Invalid GRP magic (not RGrp)";
+        mapping_.close();
         return false;
     }
 
     // Parse file table
     // The file table typically starts after the header
-    uint32_t tableOffset = sizeof(GrpHeader);
-    file.seekg(tableOffset);
+    size_t tableOffset = sizeof(GrpHeader);
 
     // Read file count (first entry in table)
-    uint32_t fileCount;
-    file.read(reinterpret_cast<char*>(&fileCount), sizeof(fileCount));
-    if (!file || fileCount > 10000) {
+    uint32_t fileCount = 0;
+    const uint8_t* countPtr = mapping_.at(tableOffset, sizeof(fileCount));
+    if (countPtr) {
+        std::memcpy(&fileCount, countPtr, sizeof(fileCount));
+    }
+    if (!countPtr || fileCount > 10000) {
         // Try alternative format - count might be at different location
-        file.seekg(header.offset1);
-        file.read(reinterpret_cast<char*>(&fileCount), sizeof(fileCount));
-        if (!file || fileCount > 10000) {
+        tableOffset = header->offset1;
+        countPtr = mapping_.at(tableOffset, sizeof(fileCount));
+        if (countPtr) {
+            std::memcpy(&fileCount, countPtr, sizeof(fileCount));
+        }
+        if (!countPtr || fileCount > 10000) {
             lastError_ = "Invalid file count in GRP archive";
+            mapping_.close();
             return false;
         }
     }
 
     // Read file entries
+    size_t entryOffset = tableOffset + sizeof(fileCount);
     entries_.reserve(fileCount);
     for (uint32_t i = 0; i < fileCount; ++i) {
-        GrpFileEntry entry;
-        file.read(reinterpret_cast<char*>(&entry), sizeof(entry));
-        if (!file) {
+        const GrpFileEntry* entry = reinterpret_cast<const GrpFileEntry*>(
+            mapping_.at(entryOffset, sizeof(GrpFileEntry)));
+        if (!entry) {
             break;
         }
+        entryOffset += sizeof(GrpFileEntry);
 
         GrpEntry grpEntry;
-        grpEntry.name = std::string(entry.name, strnlen(entry.name, 13));
-        grpEntry.offset = entry.offset;
-        grpEntry.size = entry.size;
-        grpEntry.compressedSize = entry.compressedSize;
-        grpEntry.flags = entry.flags;
-        grpEntry.isCompressed = (entry.flags & GRP_COMPRESSION_RLE) != 0 ||
-                                (entry.flags & GRP_COMPRESSION_LZ) != 0;
+        grpEntry.name = std::string(entry->name, strnlen(entry->name, 13));
+        grpEntry.offset = entry->offset;
+        grpEntry.size = entry->size;
+        grpEntry.compressedSize = entry->compressedSize;
+        grpEntry.flags = entry->flags;
+        grpEntry.isCompressed = (entry->flags & GRP_COMPRESSION_RLE) != 0 ||
+                                (entry->flags & GRP_COMPRESSION_LZ) != 0;
 
         // Normalize name to lowercase for lookup
         std::string lowerName = grpEntry.name;
@@ -99,6 +110,7 @@ bool GrpArchive::open(const std::string& path) {
 void GrpArchive::close() {
     entries_.clear();
     entryMap_.clear();
+    mapping_.close();
     filePath_.clear();
     isOpen_ = false;
 }
@@ -127,124 +139,128 @@ const GrpEntry* GrpArchive::getEntry(const std::string& name) const {
     return nullptr;
 }
 
+GrpView GrpArchive::rawView(const GrpEntry& entry, std::string* error) const {
+    // Read compressed or raw data
+    uint32_t readSize = entry.isCompressed ? entry.compressedSize : entry.size;
+    if (readSize == 0) {
+        readSize = entry.size;
+    }
+
+    GrpView result;
+    result.data = mapping_.at(entry.offset, readSize);
+    if (!result.data) {
+        setError(error, "Entry data out of range: " + entry.name);
+        return {};
+    }
+    result.size = readSize;
+    return result;
+}
+
 std::vector<uint8_t> GrpArchive::extract(const std::string& name) {
+    std::vector<uint8_t> data;
+    extract(name, data, &lastError_);
+    return data;
+}
+
+GrpView GrpArchive::view(const std::string& name) {
+    return view(name, &lastError_);
+}
+
+size_t GrpArchive::extractInto(const std::string& name, uint8_t* dst, size_t dstSize) {
+    return extractInto(name, dst, dstSize, &lastError_);
+}
+
+bool GrpArchive::extract(const std::string& name, std::vector<uint8_t>& out,
+                         std::string* error) const {
+    out.clear();
+
     const GrpEntry* entry = getEntry(name);
     if (!entry) {
-        lastError_ = "File not found: " + name;
-        return {};
+        setError(error, "File not found: " + name);
+        return false;
     }
 
-    std::ifstream file(filePath_, std::ios::binary);
-    if (!file) {
-        lastError_ = "Failed to reopen archive";
+    out.resize(entry->size);
+    size_t written = extractInto(name, out.data(), out.size(), error);
+    out.resize(written);
+    return written > 0;
+}
+
+GrpView GrpArchive::view(const std::string& name, std::string* error) const {
+    const GrpEntry* entry = getEntry(name);
+    if (!entry) {
+        setError(error, "File not found: " + name);
         return {};
     }
 
-    file.seekg(entry->offset);
-    if (!file) {
-        lastError_ = "Failed to seek to file offset";
+    if (entry->isCompressed) {
+        setError(error, "Entry is compressed, use extractInto: " + name);
         return {};
     }
 
-    // Read compressed or raw data
-    uint32_t readSize = entry->isCompressed ? entry->compressedSize : entry->size;
-    if (readSize == 0) {
-        readSize = entry->size;
+    return rawView(*entry, error);
+}
+
+size_t GrpArchive::extractInto(const std::string& name, uint8_t* dst, size_t dstSize,
+                               std::string* error) const {
+    const GrpEntry* entry = getEntry(name);
+    if (!entry) {
+        setError(error, "File not found: " + name);
+        return 0;
     }
 
-    std::vector<uint8_t> data(readSize);
-    file.read(reinterpret_cast<char*>(data.data()), readSize);
-    if (!file) {
-        lastError_ = "Failed to read file data";
-        return {};
+    if (dstSize < entry->size) {
+        setError(error, "Output buffer too small for: " + name);
+        return 0;
     }
 
-    // Decompress if needed
-    if (entry->isCompressed) {
-        if (entry->flags & GRP_COMPRESSION_RLE) {
-            return decompressRLE(data, entry->size);
-        } else if (entry->flags & GRP_COMPRESSION_LZ) {
-            return decompressLZ(data, entry->size);
-        }
+    GrpView raw = rawView(*entry, error);
+    if (!raw.data) {
+        return 0;
     }
 
-    return data;
+    return decodeEntry(entry->flags, raw.data, raw.size, dst, entry->size);
 }
 
-std::vector<uint8_t> GrpArchive::decompressRLE(const std::vector<uint8_t>& compressed, uint32_t uncompressedSize) {
-    std::vector<uint8_t> output;
-    output.reserve(uncompressedSize);
-
-    size_t i = 0;
-    while (i < compressed.size() && output.size() < uncompressedSize) {
-        uint8_t control = compressed[i++];
-
-        if (control & 0x80) {
-            // Run of same byte
-            uint8_t count = (control & 0x7F) + 1;
-            if (i >= compressed.size()) break;
-            uint8_t value = compressed[i++];
-            for (uint8_t j = 0; j < count && output.size() < uncompressedSize; ++j) {
-                output.push_back(value);
-            }
-        } else {
-            // Literal bytes
-            uint8_t count = control + 1;
-            for (uint8_t j = 0; j < count && i < compressed.size() && output.size() < uncompressedSize; ++j) {
-                output.push_back(compressed[i++]);
-            }
-        }
+size_t GrpArchive::decodeEntry(uint8_t flags, const uint8_t* src, size_t srcSize,
+                               uint8_t* dst, size_t dstSize) {
+    // Decompress if needed
+    if (flags & GRP_COMPRESSION_RLE) {
+        return decodeRLEPackBits(src, srcSize, dst, dstSize);
+    } else if (flags & GRP_COMPRESSION_LZ) {
+        return decodeLZ(src, srcSize, dst, dstSize);
     }
 
-    return output;
+    size_t copySize = std::min(srcSize, dstSize);
+    std::memcpy(dst, src, copySize);
+    return copySize;
 }
 
-std::vector<uint8_t> GrpArchive::decompressLZ(const std::vector<uint8_t>& compressed, uint32_t uncompressedSize) {
-    std::vector<uint8_t> output;
-    output.reserve(uncompressedSize);
-
-    size_t i = 0;
-    while (i < compressed.size() && output.size() < uncompressedSize) {
-        uint8_t flags = compressed[i++];
-
-        for (int bit = 0; bit < 8 && i < compressed.size() && output.size() < uncompressedSize; ++bit) {
-            if (flags & (1 << bit)) {
-                // Literal byte
-                output.push_back(compressed[i++]);
-            } else {
-                // Back reference
-                if (i + 1 >= compressed.size()) break;
-                uint16_t ref = compressed[i] | (compressed[i + 1] << 8);
-                i += 2;
-
-                uint16_t offset = (ref >> 4) + 1;
-                uint16_t length = (ref & 0x0F) + 3;
-
-                for (uint16_t j = 0; j < length && output.size() < uncompressedSize; ++j) {
-                    size_t srcIdx = output.size() - offset;
-                    if (srcIdx < output.size()) {
-                        output.push_back(output[srcIdx]);
-                    } else {
-                        output.push_back(0);
-                    }
-                }
-            }
-        }
+std::unique_ptr<Sprite> GrpArchive::extractSprite(const std::string& name) {
+    const GrpEntry* entry = getEntry(name);
+    if (!entry) {
+        lastError_ = "File not found: " + name;
+        return nullptr;
     }
 
-    return output;
-}
+    // Uncompressed sprites decode directly from the mapping
+    if (!entry->isCompressed) {
+        GrpView raw = rawView(*entry, &lastError_);
+        if (!raw.data) {
+            return nullptr;
+        }
+        return decodeSprite(raw.data, raw.size);
+    }
 
-std::unique_ptr<Sprite> GrpArchive::extractSprite(const std::string& name) {
     auto data = extract(name);
     if (data.empty()) {
         return nullptr;
     }
-    return decodeSprite(data);
+    return decodeSprite(data.data(), data.size());
 }
 
-std::unique_ptr<Sprite> GrpArchive::decodeSprite(const std::vector<uint8_t>& data) {
-    if (data.size() < sizeof(SpriteHeader)) {
+std::unique_ptr<Sprite> GrpArchive::decodeSprite(const uint8_t* data, size_t size) {
+    if (size < sizeof(SpriteHeader)) {
         lastError_ = "Sprite data too small";
         return nullptr;
     }
@@ -252,7 +268,7 @@ std::unique_ptr<Sprite> GrpArchive::decodeSprite(const std::vector<uint8_t>& dat
     auto sprite = std::make_unique<Sprite>();
 
     // Parse header
-    const SpriteHeader* header = reinterpret_cast<const SpriteHeader*>(data.data());
+    const SpriteHeader* header = reinterpret_cast<const SpriteHeader*>(data);
     sprite->width = header->width;
     sprite->height = header->height;
     sprite->hotspotX = header->hotspotX;
@@ -269,9 +285,9 @@ std::unique_ptr<Sprite> GrpArchive::decodeSprite(const std::vector<uint8_t>& dat
     size_t headerEnd = sizeof(SpriteHeader);
 
     // Check for embedded palette
-    if (header->paletteOffset > 0 && header->paletteOffset < data.size()) {
+    if (header->paletteOffset > 0 && header->paletteOffset < size) {
         size_t palOffset = header->paletteOffset;
-        size_t palSize = std::min<size_t>(256 * 3, data.size() - palOffset);
+        size_t palSize = std::min<size_t>(256 * 3, size - palOffset);
 
         sprite->palette.resize(256);
         for (size_t i = 0; i < palSize / 3; ++i) {
@@ -288,44 +304,14 @@ std::unique_ptr<Sprite> GrpArchive::decodeSprite(const std::vector<uint8_t>& dat
     }
 
     // Extract pixel data
-    if (headerEnd + pixelDataSize <= data.size()) {
-        sprite->pixels.assign(data.begin() + headerEnd,
-                              data.begin() + headerEnd + pixelDataSize);
+    if (headerEnd + pixelDataSize <= size) {
+        sprite->pixels.assign(data + headerEnd,
+                              data + headerEnd + pixelDataSize);
     } else {
-        // Might be RLE compressed sprite data
+        // Might be RLE compressed sprite data (skipped pixels stay 0)
         sprite->pixels.resize(pixelDataSize);
-        size_t srcIdx = headerEnd;
-        size_t dstIdx = 0;
-
-        while (srcIdx < data.size() && dstIdx < pixelDataSize) {
-            uint8_t cmd = data[srcIdx++];
-            if (cmd == 0) {
-                // End of line or special
-                if (srcIdx < data.size()) {
-                    uint8_t count = data[srcIdx++];
-                    if (count == 0) {
-                        // End of bitmap
-                        break;
-                    }
-                    // Skip pixels (transparent)
-                    dstIdx += count;
-                }
-            } else if (cmd < 128) {
-                // Literal run
-                for (uint8_t i = 0; i < cmd && srcIdx < data.size() && dstIdx < pixelDataSize; ++i) {
-                    sprite->pixels[dstIdx++] = data[srcIdx++];
-                }
-            } else {
-                // Repeat run
-                uint8_t count = cmd - 128;
-                if (srcIdx < data.size()) {
-                    uint8_t value = data[srcIdx++];
-                    for (uint8_t i = 0; i < count && dstIdx < pixelDataSize; ++i) {
-                        sprite->pixels[dstIdx++] = value;
-                    }
-                }
-            }
-        }
+        decodeRLESprite(data + headerEnd, size - headerEnd,
+                        sprite->pixels.data(), pixelDataSize);
     }
 
     return sprite;
@@ -0,0 +1,103 @@
+#include "load_timing.h"
+#include <cmath>
+
+namespace opengg {
+
+const char* getLoadStageName(LoadStage stage) {
+    switch (stage) {
+        case LoadStage::Resolve:    return "resolve";
+        case LoadStage::Read:       return "read";
+        case LoadStage::Decompress: return "decompress";
+        case LoadStage::Convert:    return "convert";
+        case LoadStage::Upload:     return "upload";
+    }
+    return "unknown";
+}
+
+double LoadTiming::getTotalMs() const {
+    double total = 0.0;
+    for (double ms : stageMs) {
+        total += ms;
+    }
+    return total;
+}
+
+// === StageTimer ===
+
+StageTimer::StageTimer(LoadTiming* timing, LoadStage stage)
+    : timing_(timing), stage_(stage) {
+    if (timing_) {
+        start_ = std::chrono::steady_clock::now();
+    }
+}
+
+void StageTimer::stop() {
+    if (!timing_) {
+        return;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    timing_->add(stage_, std::chrono::duration<double, std::milli>(elapsed).count());
+    timing_ = nullptr;
+}
+
+// === LatencyHistogram ===
+
+void LatencyHistogram::record(double ms) {
+    double us = ms * 1000.0;
+    size_t index = 0;
+    if (us >= 1.0) {
+        index = 1 + static_cast<size_t>(std::log2(us) * SUB_BUCKETS);
+        if (index >= BUCKET_COUNT) {
+            index = BUCKET_COUNT - 1;
+        }
+    }
+
+    buckets_[index]++;
+    count_++;
+    totalMs_ += ms;
+    if (ms > maxMs_) {
+        maxMs_ = ms;
+    }
+}
+
+void LatencyHistogram::clear() {
+    *this = LatencyHistogram();
+}
+
+double LatencyHistogram::getPercentile(double fraction) const {
+    if (count_ == 0) {
+        return 0.0;
+    }
+
+    // Rank of the wanted sample, 1-based
+    size_t rank = static_cast<size_t>(std::ceil(fraction * count_));
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    size_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            // Upper edge of the bucket, but never past the slowest sample
+            double upperMs = std::exp2(static_cast<double>(i) / SUB_BUCKETS) / 1000.0;
+            return upperMs < maxMs_ ? upperMs : maxMs_;
+        }
+    }
+    return maxMs_;
+}
+
+// === LoadProfile ===
+
+void LoadProfile::record(const LoadTiming& timing) {
+    total.record(timing.getTotalMs());
+
+    // Stages a load didn't go through would only drag the percentiles down
+    for (size_t i = 0; i < LOAD_STAGE_COUNT; ++i) {
+        if (timing.stageMs[i] > 0.0) {
+            stages[i].record(timing.stageMs[i]);
+        }
+    }
+}
+
+} // namespace opengg
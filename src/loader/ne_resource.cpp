@@ -1,4 +1,5 @@
 #include "ne_resource.h"
+#include "loader_error.h"
 #include <fstream>
 #include <cstring>
 #include <algorithm>
@@ -11,6 +12,9 @@ NEResourceExtractor::~NEResourceExtractor() = default;
 bool NEResourceExtractor::open(const std::string& path) {
     filePath_ = path;
     resources_.clear();
+    resourceIndex_.clear();
+    typeRanges_.clear();
+    mapping_.close();
 
     std::ifstream file(path, std::ios::binary);
     if (!file) {
@@ -91,6 +95,14 @@ bool NEResourceExtractor::open(const std::string& path) {
         }
     }
 
+    buildIndex();
+
+    // Map the file once; resource reads are served from the mapping
+    if (!mapping_.open(path)) {
+        lastError_ = mapping_.getLastError();
+        return false;
+    }
+
     return true;
 }
 
@@ -98,52 +110,89 @@ std::vector<Resource> NEResourceExtractor::listResources() const {
     return resources_;
 }
 
-std::vector<Resource> NEResourceExtractor::listResourcesByType(uint16_t type) const {
-    std::vector<Resource> result;
-    for (const auto& res : resources_) {
-        if (res.typeId == type) {
-            result.push_back(res);
+void NEResourceExtractor::buildIndex() {
+    // Group by type so each type occupies one contiguous range.
+    // The resource table already lists each type as one block, so this
+    // normally leaves the order untouched.
+    std::stable_sort(resources_.begin(), resources_.end(),
+                     [](const Resource& a, const Resource& b) { return a.typeId < b.typeId; });
+
+    resourceIndex_.reserve(resources_.size());
+    for (uint32_t i = 0; i < resources_.size(); ++i) {
+        const Resource& res = resources_[i];
+
+        // First entry wins for duplicate (type,id) pairs, like a linear scan would
+        resourceIndex_.emplace(indexKey(res.typeId, res.id), i);
+
+        auto range = typeRanges_.find(res.typeId);
+        if (range == typeRanges_.end()) {
+            typeRanges_[res.typeId] = {i, i + 1};
+        } else {
+            range->second.second = i + 1;
         }
     }
-    return result;
 }
 
-std::vector<uint8_t> NEResourceExtractor::extractResource(uint16_t type, uint16_t id) {
-    for (const auto& res : resources_) {
-        if (res.typeId == type && res.id == id) {
-            return extractResourceByOffset(res.offset, res.size);
-        }
+ResourceRange NEResourceExtractor::listResourcesByType(uint16_t type) const {
+    auto it = typeRanges_.find(type);
+    if (it == typeRanges_.end()) {
+        return {};
     }
-    lastError_ = "Resource not found";
-    return {};
+
+    ResourceRange range;
+    range.first = resources_.data() + it->second.first;
+    range.last = resources_.data() + it->second.second;
+    return range;
+}
+
+const Resource* NEResourceExtractor::findResource(uint16_t type, uint16_t id) const {
+    auto it = resourceIndex_.find(indexKey(type, id));
+    if (it == resourceIndex_.end()) {
+        return nullptr;
+    }
+    return &resources_[it->second];
+}
+
+std::vector<uint8_t> NEResourceExtractor::extractResource(uint16_t type, uint16_t id) {
+    std::vector<uint8_t> data;
+    readResource(type, id, data, &lastError_);
+    return data;
 }
 
 std::vector<uint8_t> NEResourceExtractor::extractResource(const Resource& res) {
-    return extractResourceByOffset(res.offset, res.size);
+    std::vector<uint8_t> data;
+    readResource(res, data, &lastError_);
+    return data;
 }
 
-std::vector<uint8_t> NEResourceExtractor::extractResourceByOffset(uint32_t offset, uint32_t size) {
-    std::ifstream file(filePath_, std::ios::binary);
-    if (!file) {
-        lastError_ = "Failed to reopen file";
-        return {};
+bool NEResourceExtractor::readResource(uint16_t type, uint16_t id, std::vector<uint8_t>& out,
+                                       std::string* error) const {
+    const Resource* res = findResource(type, id);
+    if (!res) {
+        out.clear();
+        setError(error, "Resource not found");
+        return false;
     }
+    return readAt(res->offset, res->size, out, error);
+}
 
-    file.seekg(offset);
-    if (!file) {
-        lastError_ = "Failed to seek to resource offset";
-        return {};
-    }
+bool NEResourceExtractor::readResource(const Resource& res, std::vector<uint8_t>& out,
+                                       std::string* error) const {
+    return readAt(res.offset, res.size, out, error);
+}
 
-    std::vector<uint8_t> data(size);
-    file.read(reinterpret_cast<char*>(data.data()), size);
+bool NEResourceExtractor::readAt(uint32_t offset, uint32_t size, std::vector<uint8_t>& out,
+                                 std::string* error) const {
+    out.clear();
 
-    if (!file) {
-        lastError_ = "Failed to read resource data";
-        return {};
+    const uint8_t* src = mapping_.at(offset, size);
+    if (!src) {
+        setError(error, "Failed to read resource data");
+        return false;
     }
 
-    return data;
+    out.assign(src, src + size);
+    return true;
 }
 
 bool NEResourceExtractor::extractBitmap(uint16_t id, const std::string& outPath) {
@@ -200,7 +249,7 @@ bool NEResourceExtractor::extractBitmap(uint16_t id, const std::string& outPath)
     return true;
 }
 
-std::string NEResourceExtractor::getResourceTypeName(uint16_t typeId) const {
+std::string NEResourceExtractor::getResourceTypeName(uint16_t typeId) {
     switch (typeId) {
         case NE_RT_CURSOR:       return "CURSOR";
         case NE_RT_BITMAP:       return "BITMAP";
@@ -0,0 +1,305 @@
+#include "palette.h"
+#include "loader_error.h"
+#include <cstring>
+#include <climits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define OPENGG_PALETTE_AVX2 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define OPENGG_PALETTE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace opengg {
+
+static constexpr uint32_t OPAQUE = 0xFF000000;
+
+void buildPaletteLUT(const uint8_t* bgrx, size_t colorCount, uint32_t lut[256]) {
+    size_t count = colorCount < 256 ? colorCount : 256;
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t* entry = bgrx + i * 4;
+        lut[i] = OPAQUE | (static_cast<uint32_t>(entry[2]) << 16) |
+                 (static_cast<uint32_t>(entry[1]) << 8) | entry[0];
+    }
+    for (size_t i = count; i < 256; ++i) {
+        lut[i] = OPAQUE;
+    }
+}
+
+// Four lookups per 32-bit load; also finishes the tail of the AVX2 path
+static void expandPalette8Scalar(const uint8_t* src, uint32_t* dst, size_t count,
+                                 const uint32_t lut[256]) {
+    while (count >= 4) {
+        uint32_t indices;
+        std::memcpy(&indices, src, 4);
+        dst[0] = lut[indices & 0xFF];
+        dst[1] = lut[(indices >> 8) & 0xFF];
+        dst[2] = lut[(indices >> 16) & 0xFF];
+        dst[3] = lut[indices >> 24];
+        src += 4;
+        dst += 4;
+        count -= 4;
+    }
+    while (count--) {
+        *dst++ = lut[*src++];
+    }
+}
+
+#ifdef OPENGG_PALETTE_AVX2
+
+static bool hasAVX2() {
+    static const bool supported = [] {
+#ifdef _MSC_VER
+        int regs[4];
+        __cpuid(regs, 1);
+        // The OS must save YMM state as well
+        if (!(regs[2] & (1 << 27)) || (_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+        __cpuidex(regs, 7, 0);
+        return (regs[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+    }();
+    return supported;
+}
+
+#ifdef _MSC_VER
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+// Eight lookups per gather
+TARGET_AVX2 static void expandPalette8AVX2(const uint8_t* src, uint32_t* dst, size_t count,
+                                           const uint32_t lut[256]) {
+    const int* table = reinterpret_cast<const int*>(lut);
+    while (count >= 16) {
+        __m128i indices = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        __m256i lo = _mm256_i32gather_epi32(table, _mm256_cvtepu8_epi32(indices), 4);
+        __m256i hi = _mm256_i32gather_epi32(table, _mm256_cvtepu8_epi32(_mm_srli_si128(indices, 8)), 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 8), hi);
+        src += 16;
+        dst += 16;
+        count -= 16;
+    }
+    expandPalette8Scalar(src, dst, count, lut);
+}
+
+#endif // OPENGG_PALETTE_AVX2
+
+void expandPalette8(const uint8_t* src, uint32_t* dst, size_t count, const uint32_t lut[256]) {
+#ifdef OPENGG_PALETTE_AVX2
+    if (count >= 16 && hasAVX2()) {
+        expandPalette8AVX2(src, dst, count, lut);
+        return;
+    }
+#endif
+    expandPalette8Scalar(src, dst, count, lut);
+}
+
+void expandPalette4(const uint8_t* src, uint32_t* dst, size_t count, const uint32_t lut[256]) {
+    for (size_t pairs = count / 2; pairs > 0; --pairs) {
+        uint8_t byte = *src++;
+        dst[0] = lut[byte >> 4];
+        dst[1] = lut[byte & 0x0F];
+        dst += 2;
+    }
+    if (count & 1) {
+        *dst = lut[*src >> 4];
+    }
+}
+
+void expandPalette1(const uint8_t* src, uint32_t* dst, size_t count, const uint32_t lut[256]) {
+    const uint32_t colors[2] = {lut[0], lut[1]};
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = colors[(src[i >> 3] >> (7 - (i & 7))) & 1];
+    }
+}
+
+void expandBGR24(const uint8_t* src, uint32_t* dst, size_t count) {
+#ifdef OPENGG_PALETTE_NEON
+    // Deinterleave 16 pixels and store them back with an alpha plane
+    while (count >= 16) {
+        uint8x16x3_t bgr = vld3q_u8(src);
+        uint8x16x4_t bgra;
+        bgra.val[0] = bgr.val[0];
+        bgra.val[1] = bgr.val[1];
+        bgra.val[2] = bgr.val[2];
+        bgra.val[3] = vdupq_n_u8(0xFF);
+        vst4q_u8(reinterpret_cast<uint8_t*>(dst), bgra);
+        src += 48;
+        dst += 16;
+        count -= 16;
+    }
+#endif
+
+    // Four pixels from three little-endian words
+    while (count >= 4) {
+        uint32_t w0, w1, w2;
+        std::memcpy(&w0, src, 4);
+        std::memcpy(&w1, src + 4, 4);
+        std::memcpy(&w2, src + 8, 4);
+        dst[0] = OPAQUE | (w0 & 0xFFFFFF);
+        dst[1] = OPAQUE | (w0 >> 24) | ((w1 & 0xFFFF) << 8);
+        dst[2] = OPAQUE | (w1 >> 16) | ((w2 & 0xFF) << 16);
+        dst[3] = OPAQUE | (w2 >> 8);
+        src += 12;
+        dst += 4;
+        count -= 4;
+    }
+    while (count--) {
+        *dst++ = OPAQUE | (static_cast<uint32_t>(src[2]) << 16) |
+                 (static_cast<uint32_t>(src[1]) << 8) | src[0];
+        src += 3;
+    }
+}
+
+void expandBGRX32(const uint8_t* src, uint32_t* dst, size_t count) {
+    // Plain enough for the compiler to vectorize
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t pixel;
+        std::memcpy(&pixel, src + i * 4, 4);
+        dst[i] = pixel | OPAQUE;
+    }
+}
+
+void expandBGRA32(const uint8_t* src, uint32_t* dst, size_t count) {
+    std::memcpy(dst, src, count * 4);
+}
+
+static uint32_t readLE32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static uint16_t readLE16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+bool parseBitmap(const uint8_t* data, size_t size, BitmapView& bitmap, std::string* error) {
+    // A BITMAPFILEHEADER gives the pixel offset; a bare resource has the
+    // rows right after its palette
+    size_t infoOffset = 0;
+    size_t pixelOffset = 0;
+    if (size >= 14 && data[0] == 'B' && data[1] == 'M') {
+        infoOffset = 14;
+        pixelOffset = readLE32(data + 10);
+    }
+    if (size < infoOffset + 40) {
+        setError(error, "Truncated bitmap");
+        return false;
+    }
+
+    const uint8_t* info = data + infoOffset;
+    uint32_t headerSize = readLE32(info);
+    int32_t width = static_cast<int32_t>(readLE32(info + 4));
+    int32_t height = static_cast<int32_t>(readLE32(info + 8));
+    uint16_t bitCount = readLE16(info + 14);
+    uint32_t compression = readLE32(info + 16);
+    uint32_t colorCount = readLE32(info + 32);
+
+    if (headerSize < 40 || headerSize > size - infoOffset) {
+        setError(error, "Unsupported bitmap header");
+        return false;
+    }
+    if (compression != 0) {
+        setError(error, "Compressed bitmaps not supported");
+        return false;
+    }
+    if (bitCount != 1 && bitCount != 4 && bitCount != 8 && bitCount != 24 && bitCount != 32) {
+        setError(error, "Unsupported bitmap depth: " + std::to_string(bitCount));
+        return false;
+    }
+
+    // Negative height means the rows are stored top-down
+    bool topDown = height < 0;
+    if (width <= 0 || height == 0 || height == INT32_MIN) {
+        setError(error, "Invalid bitmap size");
+        return false;
+    }
+    if (topDown) {
+        height = -height;
+    }
+
+    size_t paletteOffset = infoOffset + headerSize;
+    size_t paletteSize = 0;
+    if (bitCount <= 8) {
+        if (colorCount == 0 || colorCount > (1u << bitCount)) {
+            colorCount = 1u << bitCount;
+        }
+        paletteSize = static_cast<size_t>(colorCount) * 4;
+    }
+    if (pixelOffset == 0) {
+        pixelOffset = paletteOffset + paletteSize;
+    }
+
+    size_t rowStride = ((static_cast<size_t>(width) * bitCount + 31) / 32) * 4;
+    if (paletteOffset + paletteSize > size || pixelOffset > size ||
+        rowStride * static_cast<size_t>(height) > size - pixelOffset) {
+        setError(error, "Truncated bitmap");
+        return false;
+    }
+
+    bitmap.pixels = data + pixelOffset;
+    bitmap.rowStride = rowStride;
+    bitmap.width = width;
+    bitmap.height = height;
+    bitmap.topDown = topDown;
+    bitmap.bitCount = bitCount;
+    bitmap.hasAlpha = false;
+    if (bitCount == 32) {
+        if (headerSize >= 56) {
+            // BITMAPV3INFOHEADER and later carry an alpha mask
+            bitmap.hasAlpha = readLE32(info + 52) == OPAQUE;
+        } else {
+            // No mask: alpha is meaningful only if some pixel sets it
+            for (int y = 0; y < height && !bitmap.hasAlpha; ++y) {
+                const uint8_t* row = bitmap.pixels + static_cast<size_t>(y) * rowStride;
+                for (int x = 0; x < width; ++x) {
+                    if (row[x * 4 + 3] != 0) {
+                        bitmap.hasAlpha = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    if (bitCount <= 8) {
+        buildPaletteLUT(data + paletteOffset, colorCount, bitmap.lut);
+    }
+    return true;
+}
+
+void expandBitmap(const BitmapView& bitmap, uint8_t* dst, size_t pitch) {
+    const size_t width = static_cast<size_t>(bitmap.width);
+    for (int y = 0; y < bitmap.height; ++y) {
+        int srcY = bitmap.topDown ? y : (bitmap.height - 1 - y);
+        const uint8_t* srcRow = bitmap.pixels + static_cast<size_t>(srcY) * bitmap.rowStride;
+        uint32_t* dstRow = reinterpret_cast<uint32_t*>(dst + static_cast<size_t>(y) * pitch);
+
+        switch (bitmap.bitCount) {
+            case 8:  expandPalette8(srcRow, dstRow, width, bitmap.lut); break;
+            case 4:  expandPalette4(srcRow, dstRow, width, bitmap.lut); break;
+            case 1:  expandPalette1(srcRow, dstRow, width, bitmap.lut); break;
+            case 24: expandBGR24(srcRow, dstRow, width); break;
+            case 32:
+                if (bitmap.hasAlpha) {
+                    expandBGRA32(srcRow, dstRow, width);
+                } else {
+                    expandBGRX32(srcRow, dstRow, width);
+                }
+                break;
+        }
+    }
+}
+
+} // namespace opengg
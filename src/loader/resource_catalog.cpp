@@ -0,0 +1,502 @@
+#include "resource_catalog.h"
+#include "loader_error.h"
+#include "ne_resource.h"
+#include "grp_archive.h"
+#include "mapped_file.h"
+#include "crc32.h"
+#include "load_timing.h"
+#include "directory_index.h"
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+namespace opengg {
+
+static constexpr char CATALOG_MAGIC[4] = {'O', 'G', 'R', 'C'};
+static constexpr uint32_t CATALOG_VERSION = 2;
+
+static int64_t getModifiedTime(const std::string& path) {
+    std::error_code ec;
+    auto time = fs::last_write_time(path, ec);
+    if (ec) {
+        return 0;
+    }
+    return static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+ResourceCatalog::ResourceCatalog() {
+    clear();
+}
+
+ResourceCatalog::~ResourceCatalog() = default;
+
+void ResourceCatalog::clear() {
+    files_.clear();
+    entries_.clear();
+    fileMap_.clear();
+
+    // Offset 0 is always the empty string
+    strings_.assign(1, '\0');
+    gamePathOffset_ = 0;
+
+    std::lock_guard<std::mutex> lock(mappingMutex_);
+    mappings_.clear();
+}
+
+bool ResourceCatalog::build(const std::string& gamePath, const std::vector<std::string>& searchDirs) {
+    // Keep the previous contents so unchanged files needn't be parsed and hashed again
+    ResourceCatalog previous;
+    previous.files_.swap(files_);
+    previous.entries_.swap(entries_);
+    previous.strings_.swap(strings_);
+
+    clear();
+    gamePathOffset_ = addString(gamePath);
+
+    for (const auto& dir : searchDirs) {
+        std::string dirPath = dir.empty() ? gamePath : gamePath + "/" + dir;
+
+        std::error_code ec;
+        if (!fs::is_directory(dirPath, ec)) {
+            continue;
+        }
+
+        // Sort so the catalog (and first-match priority) is deterministic
+        std::vector<fs::path> paths;
+        for (const auto& entry : fs::directory_iterator(dirPath, ec)) {
+            if (entry.is_regular_file(ec)) {
+                paths.push_back(entry.path());
+            }
+        }
+        std::sort(paths.begin(), paths.end());
+
+        for (const auto& path : paths) {
+            std::string ext = toLower(path.extension().string());
+            if ((ext == ".dat" || ext == ".rsc" || ext == ".dll" || ext == ".grp") &&
+                reuseFile(previous, path.string())) {
+                continue;
+            }
+            if (ext == ".dat" || ext == ".rsc" || ext == ".dll") {
+                addNEFile(path.string());
+            } else if (ext == ".grp") {
+                addGrpFile(path.string());
+            }
+        }
+    }
+
+    buildFileMap();
+    return true;
+}
+
+bool ResourceCatalog::addNEFile(const std::string& path) {
+    NEResourceExtractor ne;
+    if (!ne.open(path)) {
+        // Not every .DAT is an NE file (e.g. raw speech data)
+        return false;
+    }
+
+    CatalogFile file = {};
+    file.nameOffset = addString(toLower(fs::path(path).filename().string()));
+    file.pathOffset = addString(path);
+    std::error_code ec;
+    file.fileSize = static_cast<uint64_t>(fs::file_size(path, ec));
+    file.modifiedTime = getModifiedTime(path);
+    file.firstEntry = static_cast<uint32_t>(entries_.size());
+    file.kind = static_cast<uint8_t>(CatalogFileKind::NE);
+
+    uint32_t fileIndex = static_cast<uint32_t>(files_.size());
+    std::vector<uint8_t> data;
+    for (const auto& res : ne.listResources()) {
+        CatalogEntry entry = {};
+        entry.fileIndex = fileIndex;
+        entry.offset = res.offset;
+        entry.size = res.size;
+        entry.decodedSize = res.size;
+        entry.type = res.typeId;
+        entry.id = res.id;
+        entry.flags = res.flags;
+        entry.nameOffset = addString(res.name);
+        if (ne.readResource(res, data)) {
+            entry.crc32 = crc32(data.data(), data.size());
+        }
+        entries_.push_back(entry);
+    }
+
+    file.entryCount = static_cast<uint32_t>(entries_.size()) - file.firstEntry;
+
+    // Order by (type, id) for binary search; stable so duplicates keep file order
+    std::stable_sort(entries_.begin() + file.firstEntry, entries_.end(),
+        [](const CatalogEntry& a, const CatalogEntry& b) {
+            return a.type != b.type ? a.type < b.type : a.id < b.id;
+        });
+
+    files_.push_back(file);
+    return true;
+}
+
+bool ResourceCatalog::addGrpFile(const std::string& path) {
+    GrpArchive grp;
+    if (!grp.open(path)) {
+        return false;
+    }
+
+    MappedFile mapping;
+    if (!mapping.open(path)) {
+        return false;
+    }
+
+    CatalogFile file = {};
+    file.nameOffset = addString(toLower(fs::path(path).filename().string()));
+    file.pathOffset = addString(path);
+    file.fileSize = mapping.size();
+    file.modifiedTime = getModifiedTime(path);
+    file.firstEntry = static_cast<uint32_t>(entries_.size());
+    file.kind = static_cast<uint8_t>(CatalogFileKind::GRP);
+
+    uint32_t fileIndex = static_cast<uint32_t>(files_.size());
+    for (const auto& name : grp.listFiles()) {
+        const GrpEntry* grpEntry = grp.getEntry(name);
+        if (!grpEntry) {
+            continue;
+        }
+
+        uint32_t storedSize = grpEntry->isCompressed ? grpEntry->compressedSize : grpEntry->size;
+        if (storedSize == 0) {
+            storedSize = grpEntry->size;
+        }
+
+        CatalogEntry entry = {};
+        entry.fileIndex = fileIndex;
+        entry.offset = grpEntry->offset;
+        entry.size = storedSize;
+        entry.decodedSize = grpEntry->size;
+        entry.nameOffset = addString(toLower(name));
+        entry.flags = grpEntry->flags;
+        if (const uint8_t* stored = mapping.at(entry.offset, entry.size)) {
+            entry.crc32 = crc32(stored, entry.size);
+        }
+        entries_.push_back(entry);
+    }
+
+    file.entryCount = static_cast<uint32_t>(entries_.size()) - file.firstEntry;
+
+    // Order by name for binary search
+    std::stable_sort(entries_.begin() + file.firstEntry, entries_.end(),
+        [this](const CatalogEntry& a, const CatalogEntry& b) {
+            return std::strcmp(getString(a.nameOffset), getString(b.nameOffset)) < 0;
+        });
+
+    files_.push_back(file);
+    return true;
+}
+
+bool ResourceCatalog::reuseFile(const ResourceCatalog& previous, const std::string& path) {
+    for (const auto& old : previous.files_) {
+        if (path != previous.getString(old.pathOffset)) {
+            continue;
+        }
+
+        std::error_code ec;
+        uint64_t size = static_cast<uint64_t>(fs::file_size(path, ec));
+        if (ec || size != old.fileSize || getModifiedTime(path) != old.modifiedTime) {
+            return false;
+        }
+
+        CatalogFile file = old;
+        file.nameOffset = addString(previous.getString(old.nameOffset));
+        file.pathOffset = addString(path);
+        file.firstEntry = static_cast<uint32_t>(entries_.size());
+
+        uint32_t fileIndex = static_cast<uint32_t>(files_.size());
+        for (const CatalogEntry* it = previous.entriesBegin(old); it != previous.entriesEnd(old); ++it) {
+            CatalogEntry entry = *it;
+            entry.fileIndex = fileIndex;
+            entry.nameOffset = addString(previous.getString(it->nameOffset));
+            entries_.push_back(entry);
+        }
+
+        files_.push_back(file);
+        return true;
+    }
+    return false;
+}
+
+uint32_t ResourceCatalog::addString(const std::string& str) {
+    if (str.empty()) {
+        return 0;
+    }
+    uint32_t offset = static_cast<uint32_t>(strings_.size());
+    strings_.insert(strings_.end(), str.begin(), str.end());
+    strings_.push_back('\0');
+    return offset;
+}
+
+const char* ResourceCatalog::getString(uint32_t offset) const {
+    if (offset >= strings_.size()) {
+        return "";
+    }
+    return strings_.data() + offset;
+}
+
+void ResourceCatalog::buildFileMap() {
+    fileMap_.clear();
+    for (uint32_t i = 0; i < files_.size(); ++i) {
+        // First file wins, matching the search directory priority
+        fileMap_.emplace(getString(files_[i].nameOffset), i);
+    }
+}
+
+bool ResourceCatalog::load(const std::string& path) {
+    clear();
+
+    // Read the whole catalog in one go
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        lastError_ = "Failed to open catalog: " + path;
+        return false;
+    }
+
+    auto fileSize = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+
+    std::vector<uint8_t> blob(fileSize);
+    file.read(reinterpret_cast<char*>(blob.data()), fileSize);
+    if (!file || fileSize < sizeof(CatalogHeader)) {
+        lastError_ = "Failed to read catalog: " + path;
+        return false;
+    }
+
+    CatalogHeader header;
+    std::memcpy(&header, blob.data(), sizeof(header));
+    if (std::memcmp(header.magic, CATALOG_MAGIC, 4) != 0 || header.version != CATALOG_VERSION) {
+        lastError_ = "Unsupported catalog format: " + path;
+        return false;
+    }
+
+    size_t filesBytes = static_cast<size_t>(header.fileCount) * sizeof(CatalogFile);
+    size_t entriesBytes = static_cast<size_t>(header.entryCount) * sizeof(CatalogEntry);
+    size_t expected = sizeof(CatalogHeader) + filesBytes + entriesBytes + header.stringPoolSize;
+    if (expected != fileSize || header.stringPoolSize == 0) {
+        lastError_ = "Catalog is truncated: " + path;
+        return false;
+    }
+
+    const uint8_t* ptr = blob.data() + sizeof(CatalogHeader);
+    files_.resize(header.fileCount);
+    std::memcpy(files_.data(), ptr, filesBytes);
+    ptr += filesBytes;
+
+    entries_.resize(header.entryCount);
+    std::memcpy(entries_.data(), ptr, entriesBytes);
+    ptr += entriesBytes;
+
+    strings_.assign(reinterpret_cast<const char*>(ptr),
+                    reinterpret_cast<const char*>(ptr) + header.stringPoolSize);
+    gamePathOffset_ = header.gamePathOffset;
+
+    // Reject catalogs whose file ranges don't line up with the entry table
+    for (const auto& f : files_) {
+        if (f.firstEntry > entries_.size() || f.entryCount > entries_.size() - f.firstEntry) {
+            clear();
+            lastError_ = "Catalog is corrupt: " + path;
+            return false;
+        }
+    }
+    if (strings_.back() != '\0') {
+        clear();
+        lastError_ = "Catalog is corrupt: " + path;
+        return false;
+    }
+
+    buildFileMap();
+    return true;
+}
+
+bool ResourceCatalog::save(const std::string& path) const {
+    CatalogHeader header;
+    std::memcpy(header.magic, CATALOG_MAGIC, 4);
+    header.version = CATALOG_VERSION;
+    header.fileCount = static_cast<uint32_t>(files_.size());
+    header.entryCount = static_cast<uint32_t>(entries_.size());
+    header.stringPoolSize = static_cast<uint32_t>(strings_.size());
+    header.gamePathOffset = gamePathOffset_;
+
+    // Write to a temp file and rename, so a crash never leaves a torn catalog
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(files_.data()), files_.size() * sizeof(CatalogFile));
+        file.write(reinterpret_cast<const char*>(entries_.data()), entries_.size() * sizeof(CatalogEntry));
+        file.write(strings_.data(), strings_.size());
+        if (!file) {
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tempPath, path, ec);
+    return !ec;
+}
+
+bool ResourceCatalog::isStale(const std::string& gamePath) const {
+    if (gamePath != getString(gamePathOffset_)) {
+        return true;
+    }
+
+    for (const auto& file : files_) {
+        std::string path = getString(file.pathOffset);
+        std::error_code ec;
+        uint64_t size = static_cast<uint64_t>(fs::file_size(path, ec));
+        if (ec || size != file.fileSize || getModifiedTime(path) != file.modifiedTime) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+const CatalogFile* ResourceCatalog::findFile(const std::string& filename) const {
+    auto it = fileMap_.find(toLower(filename));
+    if (it == fileMap_.end()) {
+        return nullptr;
+    }
+    return &files_[it->second];
+}
+
+const CatalogEntry* ResourceCatalog::findResource(const std::string& filename,
+                                                  uint16_t type, uint16_t id) const {
+    const CatalogFile* file = findFile(filename);
+    if (!file || file->kind != static_cast<uint8_t>(CatalogFileKind::NE)) {
+        return nullptr;
+    }
+
+    const CatalogEntry* begin = entriesBegin(*file);
+    const CatalogEntry* end = entriesEnd(*file);
+    const CatalogEntry* it = std::lower_bound(begin, end, std::make_pair(type, id),
+        [](const CatalogEntry& e, const std::pair<uint16_t, uint16_t>& key) {
+            return e.type != key.first ? e.type < key.first : e.id < key.second;
+        });
+
+    if (it == end || it->type != type || it->id != id) {
+        return nullptr;
+    }
+    return it;
+}
+
+const CatalogEntry* ResourceCatalog::findEntry(const std::string& filename,
+                                               const std::string& entryName) const {
+    const CatalogFile* file = findFile(filename);
+    if (!file || file->kind != static_cast<uint8_t>(CatalogFileKind::GRP)) {
+        return nullptr;
+    }
+
+    std::string lowerName = toLower(entryName);
+    const CatalogEntry* begin = entriesBegin(*file);
+    const CatalogEntry* end = entriesEnd(*file);
+    const CatalogEntry* it = std::lower_bound(begin, end, lowerName,
+        [this](const CatalogEntry& e, const std::string& key) {
+            return std::strcmp(getString(e.nameOffset), key.c_str()) < 0;
+        });
+
+    if (it == end || lowerName != getString(it->nameOffset)) {
+        return nullptr;
+    }
+    return it;
+}
+
+const CatalogEntry* ResourceCatalog::entriesBegin(const CatalogFile& file) const {
+    return entries_.data() + file.firstEntry;
+}
+
+const CatalogEntry* ResourceCatalog::entriesEnd(const CatalogFile& file) const {
+    return entries_.data() + file.firstEntry + file.entryCount;
+}
+
+std::string ResourceCatalog::getFilePath(const CatalogFile& file) const {
+    return getString(file.pathOffset);
+}
+
+std::string ResourceCatalog::getEntryName(const CatalogEntry& entry) const {
+    return getString(entry.nameOffset);
+}
+
+const MappedFile* ResourceCatalog::getMapping(uint32_t fileIndex) const {
+    std::lock_guard<std::mutex> lock(mappingMutex_);
+
+    if (mappings_.size() < files_.size()) {
+        mappings_.resize(files_.size());
+    }
+
+    auto& mapping = mappings_[fileIndex];
+    if (!mapping) {
+        auto file = std::make_unique<MappedFile>();
+        if (!file->open(getString(files_[fileIndex].pathOffset))) {
+            return nullptr;
+        }
+        mapping = std::move(file);
+    }
+    return mapping.get();
+}
+
+bool ResourceCatalog::read(const CatalogEntry& entry, std::vector<uint8_t>& out,
+                           std::string* error, LoadTiming* timing) const {
+    StageTimer readTimer(timing, LoadStage::Read);
+    out.clear();
+
+    if (entry.fileIndex >= files_.size()) {
+        setError(error, "Invalid catalog entry");
+        return false;
+    }
+
+    const CatalogFile& file = files_[entry.fileIndex];
+    if (entry.size == 0) {
+        setError(error, "Empty resource in: " + getFilePath(file));
+        return false;
+    }
+
+    const MappedFile* mapping = getMapping(entry.fileIndex);
+    if (!mapping) {
+        setError(error, "Failed to map file: " + getFilePath(file));
+        return false;
+    }
+
+    const uint8_t* src = mapping->at(entry.offset, entry.size);
+    if (!src) {
+        setError(error, "Resource data out of range in: " + getFilePath(file));
+        return false;
+    }
+
+    if (timing) {
+        timing->bytesFromDisk += entry.size;
+    }
+
+    if (file.kind == static_cast<uint8_t>(CatalogFileKind::GRP) &&
+        (entry.flags & (GRP_COMPRESSION_RLE | GRP_COMPRESSION_LZ))) {
+        // Pages of a mapping are read on first touch, so some of the
+        // file I/O is counted here
+        readTimer.stop();
+        StageTimer decompressTimer(timing, LoadStage::Decompress);
+        out.resize(entry.decodedSize);
+        size_t written = GrpArchive::decodeEntry(static_cast<uint8_t>(entry.flags), src, entry.size,
+                                                 out.data(), out.size());
+        out.resize(written);
+        if (written == 0) {
+            setError(error, "Failed to decompress entry in: " + getFilePath(file));
+            return false;
+        }
+        return true;
+    }
+
+    out.assign(src, src + entry.size);
+    return true;
+}
+
+} // namespace opengg
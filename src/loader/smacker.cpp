@@ -1,6 +1,8 @@
 #include "smacker.h"
+#include "palette.h"
 #include <cstring>
 #include <algorithm>
+#include <chrono>
 
 #ifdef SDL_h_
 #include <SDL.h>
@@ -15,7 +17,7 @@ struct SmkHeader {
     uint32_t width;
     uint32_t height;
     uint32_t frameCount;
-    int32_t  frameRate;     // Negative = microseconds per frame
+    int32_t  frameRate;     // Milliseconds per frame; negative = units of 10 microseconds
     uint32_t flags;
     uint32_t audioSize[7];
     uint32_t treesSize;
@@ -28,14 +30,303 @@ struct SmkHeader {
 };
 #pragma pack(pop)
 
-// Huffman tree node
-struct SmackerPlayer::TreeNode {
-    bool isLeaf;
-    uint16_t value;
-    std::unique_ptr<TreeNode> left;
-    std::unique_ptr<TreeNode> right;
+// Frame type flags
+constexpr uint8_t SMK_FRAME_PALETTE = 0x01;     // Followed by audio track bits 0x02 << track
 
-    TreeNode() : isLeaf(false), value(0) {}
+// Header flags
+constexpr uint32_t SMK_FLAG_RING_FRAME = 0x01;  // An extra frame (a copy of frame 0) for looping
+
+// Video block types (low two bits of a TYPE code)
+enum SmkBlockType {
+    SMK_BLOCK_MONO = 0,     // Two colors and a 16-bit mask
+    SMK_BLOCK_FULL = 1,     // All 16 pixels
+    SMK_BLOCK_SKIP = 2,     // Unchanged from the previous frame
+    SMK_BLOCK_FILL = 3      // One color (the TYPE code's high byte)
+};
+
+// Blocks covered by one TYPE code, by bits 2-7 of the code
+static const uint16_t SMK_BLOCK_RUNS[64] = {
+     1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15, 16,
+    17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32,
+    33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48,
+    49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 128, 256, 512, 1024, 2048
+};
+
+// Bytes read from the file at a time, so sequential frames come from memory
+constexpr size_t SMK_READ_AHEAD = 1 << 20;
+
+// Largest decoded audio chunk accepted, in bytes
+constexpr uint32_t SMK_MAX_AUDIO_CHUNK = 1 << 22;
+
+// Longest Huffman code the trees may hold
+constexpr unsigned SMK_MAX_CODE_LENGTH = 32;
+
+// Bits resolved by the first lookup; longer codes go through sub-tables
+constexpr unsigned SMK_ROOT_BITS = 11;
+constexpr unsigned SMK_SUB_BITS = 8;
+
+// Adds the time from construction to destruction to a stage of the
+// player's SmackerDecodeStats; does nothing when none is attached
+class SmkStageTimer {
+public:
+    explicit SmkStageTimer(double* stageMs) : stageMs_(stageMs) {
+        if (stageMs_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~SmkStageTimer() {
+        if (stageMs_) {
+            *stageMs_ += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+        }
+    }
+
+    SmkStageTimer(const SmkStageTimer&) = delete;
+    SmkStageTimer& operator=(const SmkStageTimer&) = delete;
+
+private:
+    double* stageMs_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Reads a Smacker bitstream (least significant bit first) through a 64-bit
+// buffer refilled a word at a time. Reads past the end return zero bits
+// and set overrun().
+class SmkBitReader {
+public:
+    SmkBitReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    // Next 32 bits, without consuming them
+    uint32_t peek() {
+        if (count_ < 32) {
+            refill();
+        }
+        return static_cast<uint32_t>(buffer_);
+    }
+
+    void skip(unsigned bits) {
+        buffer_ >>= bits;
+        count_ -= bits;
+    }
+
+    uint32_t read(unsigned bits) {
+        uint32_t value = peek() & static_cast<uint32_t>((1ull << bits) - 1);
+        skip(bits);
+        return value;
+    }
+
+    bool readBit() { return read(1) != 0; }
+
+    bool overrun() const { return pos_ * 8 - count_ > size_ * 8; }
+
+private:
+    void refill() {
+        if (pos_ + 8 <= size_) {
+            // Whole bytes that fit go in; the bits of the next partial byte
+            // are loaded too, but are the same ones the next refill ORs in
+            uint64_t word;
+            std::memcpy(&word, data_ + pos_, 8);
+            buffer_ |= word << count_;
+            pos_ += (63 - count_) >> 3;
+            count_ |= 56;
+            return;
+        }
+        while (count_ <= 56) {
+            uint64_t byte = pos_ < size_ ? data_[pos_] : 0;
+            buffer_ |= byte << count_;
+            pos_++;
+            count_ += 8;
+        }
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+    uint64_t buffer_ = 0;
+    unsigned count_ = 0;
+};
+
+// One leaf of a Huffman tree: its code (first bit in bit 0) and symbol
+struct SmkCode {
+    uint32_t bits;
+    unsigned length;
+    uint32_t symbol;
+};
+
+// Multi-level lookup table over a Huffman tree. The root table is indexed
+// by the next SMK_ROOT_BITS bits (or fewer for a shallow tree); entries for
+// longer codes point to sub-tables indexed by the bits that follow.
+class SmkHuffTable {
+public:
+    void build(const std::vector<SmkCode>& codes) {
+        unsigned maxLength = 0;
+        std::vector<const SmkCode*> all;
+        for (const auto& code : codes) {
+            maxLength = std::max(maxLength, code.length);
+            all.push_back(&code);
+        }
+
+        unsigned rootBits = std::min(maxLength, SMK_ROOT_BITS);
+        rootMask_ = (1u << rootBits) - 1;
+        table_.clear();
+        buildLevel(all, 0, rootBits);
+    }
+
+    uint32_t decode(SmkBitReader& bits) const {
+        uint32_t window = bits.peek();
+        const Entry* entry = &table_[window & rootMask_];
+        while (entry->subBits) {
+            entry = &table_[entry->value + ((window >> entry->length) & ((1u << entry->subBits) - 1))];
+        }
+        bits.skip(entry->length);
+        return entry->value;
+    }
+
+private:
+    // A symbol and its total code length, or (subBits > 0) the offset of a
+    // sub-table indexed from bit `length`
+    struct Entry {
+        uint32_t value = 0;
+        uint8_t length = 0;
+        uint8_t subBits = 0;
+    };
+
+    // Table for the codes sharing their first `shift` bits, indexed by the
+    // next levelBits bits. Returns its offset.
+    uint32_t buildLevel(const std::vector<const SmkCode*>& codes, unsigned shift, unsigned levelBits) {
+        uint32_t offset = static_cast<uint32_t>(table_.size());
+        uint32_t size = 1u << levelBits;
+        unsigned end = shift + levelBits;
+        table_.resize(table_.size() + size);
+
+        std::vector<std::vector<const SmkCode*>> longer(size);
+        for (const SmkCode* code : codes) {
+            uint32_t index = (code->bits >> shift) & (size - 1);
+            if (code->length > end) {
+                longer[index].push_back(code);
+                continue;
+            }
+
+            // Every index whose low bits match the rest of the code
+            uint32_t step = 1u << (code->length - shift);
+            for (uint32_t fill = index; fill < size; fill += step) {
+                Entry& entry = table_[offset + fill];
+                entry.value = code->symbol;
+                entry.length = static_cast<uint8_t>(code->length);
+                entry.subBits = 0;
+            }
+        }
+
+        for (uint32_t index = 0; index < size; ++index) {
+            if (longer[index].empty()) {
+                continue;
+            }
+            unsigned maxLength = 0;
+            for (const SmkCode* code : longer[index]) {
+                maxLength = std::max(maxLength, code->length);
+            }
+            unsigned subBits = std::min(maxLength - end, SMK_SUB_BITS);
+            uint32_t subOffset = buildLevel(longer[index], end, subBits);
+
+            Entry& entry = table_[offset + index];
+            entry.value = subOffset;
+            entry.length = static_cast<uint8_t>(end);
+            entry.subBits = static_cast<uint8_t>(subBits);
+        }
+        return offset;
+    }
+
+    std::vector<Entry> table_;
+    uint32_t rootMask_ = 0;
+};
+
+// Read an 8-bit tree: 1 = node (0 branch, then 1 branch), 0 = leaf
+// followed by its 8-bit value
+static bool readByteTree(SmkBitReader& bits, uint32_t prefix, unsigned length, std::vector<SmkCode>& codes) {
+    if (length > SMK_MAX_CODE_LENGTH || codes.size() >= 256 || bits.overrun()) {
+        return false;
+    }
+    if (!bits.readBit()) {
+        codes.push_back({prefix, length, bits.read(8)});
+        return true;
+    }
+    if (length == SMK_MAX_CODE_LENGTH) {
+        return false;
+    }
+    return readByteTree(bits, prefix, length + 1, codes) &&
+           readByteTree(bits, prefix | (1u << length), length + 1, codes);
+}
+
+// A 16-bit tree of the file header. Leaf values are coded with two 8-bit
+// trees (low and high byte). Three escape values mark leaves that instead
+// return one of the three most recent distinct values decoded, which are
+// kept in extra slots and reset at the start of every frame.
+struct SmackerPlayer::BigTree {
+    SmkHuffTable table;             // Code to slot
+    std::vector<uint16_t> values;   // Per slot
+    uint32_t recent[3] = {};        // Slots of the most recent values
+
+    // A missing tree decodes every code as 0 without reading any bits
+    void setEmpty() {
+        values.assign(2, 0);
+        recent[0] = recent[1] = recent[2] = 1;
+        table.build({{0, 0, 0}});
+    }
+
+    void resetRecent() {
+        values[recent[0]] = values[recent[1]] = values[recent[2]] = 0;
+    }
+
+    uint16_t decode(SmkBitReader& bits) {
+        uint16_t value = values[table.decode(bits)];
+        if (value != values[recent[0]]) {
+            values[recent[2]] = values[recent[1]];
+            values[recent[1]] = values[recent[0]];
+            values[recent[0]] = value;
+        }
+        return value;
+    }
+};
+
+// Everything needed while reading one big tree's leaves
+struct SmkBigTreeReader {
+    explicit SmkBigTreeReader(SmkBitReader& reader) : bits(reader) {}
+
+    SmkBitReader& bits;
+    SmkHuffTable byteTables[2];     // Low, high
+    uint16_t escapes[3] = {};
+    int64_t escapeSlots[3] = {-1, -1, -1};
+    uint32_t entries = 0;           // Nodes and leaves so far
+    uint32_t maxEntries = 0;        // From the header's tree size
+    std::vector<SmkCode> codes;
+    std::vector<uint16_t> values;
+
+    bool read(uint32_t prefix, unsigned length) {
+        if (length > SMK_MAX_CODE_LENGTH || entries + 1 >= maxEntries || bits.overrun()) {
+            return false;
+        }
+        entries++;
+
+        if (bits.readBit()) {
+            return length < SMK_MAX_CODE_LENGTH &&
+                   read(prefix, length + 1) && read(prefix | (1u << length), length + 1);
+        }
+
+        uint32_t slot = static_cast<uint32_t>(values.size());
+        uint32_t low = byteTables[0].decode(bits);
+        uint32_t high = byteTables[1].decode(bits);
+        uint16_t value = static_cast<uint16_t>(low | (high << 8));
+        for (int i = 0; i < 3; ++i) {
+            if (value == escapes[i]) {
+                escapeSlots[i] = slot;
+                value = 0;
+                break;
+            }
+        }
+        codes.push_back({prefix, length, slot});
+        values.push_back(value);
+        return true;
+    }
 };
 
 SmackerPlayer::SmackerPlayer() {
@@ -64,16 +355,14 @@ bool SmackerPlayer::open(const std::string& path) {
         return false;
     }
 
-    // Allocate frame buffer
+    // Allocate frame buffer and change tracking
     frameBuffer_.resize(static_cast<size_t>(width_) * height_, 0);
-    frameRGB_.resize(static_cast<size_t>(width_) * height_ * 3, 0);
+    changedBlocks_.resize(static_cast<size_t>(width_ / 4) * (height_ / 4));
+    textureRows_.resize((static_cast<size_t>(height_) + 3) / 4);
 
-    // Initialize default grayscale palette
-    for (int i = 0; i < 256; ++i) {
-        palette_[i * 3] = static_cast<uint8_t>(i);
-        palette_[i * 3 + 1] = static_cast<uint8_t>(i);
-        palette_[i * 3 + 2] = static_cast<uint8_t>(i);
-    }
+    resetPalette();
+    keyPalettes_[0] = palette_;
+    markAllChanged();
 
     isOpen_ = true;
     currentFrame_ = 0;
@@ -81,11 +370,26 @@ bool SmackerPlayer::open(const std::string& path) {
 }
 
 void SmackerPlayer::close() {
+    stopPlayback();
+    ring_.clear();
+    disableAudioStream();
+
     file_.close();
     frameSizes_.clear();
     frameTypes_.clear();
+    frameOffsets_.clear();
+    readAhead_.clear();
+    readAheadOffset_ = 0;
+    keyFrames_.clear();
+    keyPalettes_.clear();
+    for (auto& tree : trees_) {
+        tree.reset();
+    }
     frameBuffer_.clear();
     frameRGB_.clear();
+    frameRGBValid_ = false;
+    changedBlocks_.clear();
+    textureRows_.clear();
     palette_.clear();
     palette_.resize(256 * 3, 0);
 
@@ -119,17 +423,34 @@ bool SmackerPlayer::readHeader() {
         return false;
     }
 
+    if (header.width == 0 || header.height == 0 || header.width > 4096 || header.height > 4096) {
+        lastError_ = "Invalid SMK dimensions";
+        return false;
+    }
+
+    // Frame 0 is always a keyframe; seeking and open() rely on it existing
+    if (header.frameCount == 0) {
+        lastError_ = "SMK file has no frames";
+        return false;
+    }
+
     width_ = header.width;
     height_ = header.height;
     frameCount_ = header.frameCount;
+    flags_ = header.flags;
+    isV4_ = header.signature[3] == '4';
     treeSize_ = header.treesSize;
+    bigTreeSizes_[0] = header.mMapSize;
+    bigTreeSizes_[1] = header.mClrSize;
+    bigTreeSizes_[2] = header.fullSize;
+    bigTreeSizes_[3] = header.typeSize;
 
-    // Handle frame rate (can be negative for microseconds)
+    // Handle frame rate (negative means units of 10 microseconds)
     if (header.frameRate > 0) {
         frameRateNum_ = 1000;
         frameRateDen_ = header.frameRate;
     } else if (header.frameRate < 0) {
-        frameRateNum_ = 1000000;
+        frameRateNum_ = 100000;
         frameRateDen_ = -header.frameRate;
     } else {
         frameRateNum_ = 10;
@@ -144,45 +465,128 @@ bool SmackerPlayer::readHeader() {
         audioInfo_[i].channels = (rate & 0x10000000) ? 2 : 1;
         audioInfo_[i].bitsPerSample = (rate & 0x20000000) ? 16 : 8;
         audioInfo_[i].isCompressed = (rate & 0x80000000) != 0;
+
+        // The header holds each track's largest decoded chunk; reserving it
+        // keeps per-frame decoding free of allocations
+        audioBuffers_[i].clear();
+        audioBuffers_[i].reserve(std::min(header.audioSize[i], SMK_MAX_AUDIO_CHUNK) / 2 *
+                                 (audioInfo_[i].bitsPerSample == 16 ? 1 : 2));
     }
 
     return true;
 }
 
 bool SmackerPlayer::readFrameSizes() {
-    frameSizes_.resize(frameCount_);
-    frameTypes_.resize(frameCount_);
+    // The ring frame is stored after the last one but never played
+    uint32_t storedFrames = frameCount_ + ((flags_ & SMK_FLAG_RING_FRAME) ? 1 : 0);
+    frameSizes_.resize(storedFrames);
+    frameTypes_.resize(storedFrames);
 
     // Read frame sizes
-    file_.read(reinterpret_cast<char*>(frameSizes_.data()), frameCount_ * sizeof(uint32_t));
+    file_.read(reinterpret_cast<char*>(frameSizes_.data()), storedFrames * sizeof(uint32_t));
     if (!file_) {
         lastError_ = "Failed to read frame sizes";
         return false;
     }
 
     // Read frame types
-    file_.read(reinterpret_cast<char*>(frameTypes_.data()), frameCount_);
+    file_.read(reinterpret_cast<char*>(frameTypes_.data()), storedFrames);
     if (!file_) {
         lastError_ = "Failed to read frame types";
         return false;
     }
 
-    // Skip Huffman trees (we'll read them per-frame for simplicity)
-    file_.seekg(treeSize_, std::ios::cur);
+    // Huffman trees, turned into lookup tables once for the whole file
+    std::vector<uint8_t> trees(treeSize_);
+    file_.read(reinterpret_cast<char*>(trees.data()), treeSize_);
     if (!file_) {
-        lastError_ = "Failed to skip trees";
+        lastError_ = "Failed to read trees";
+        return false;
+    }
+    SmkStageTimer timer(stats_ ? &stats_->treesMs : nullptr);
+    if (!readTrees(trees.data(), trees.size())) {
         return false;
     }
 
     // Remember data start offset
     dataOffset_ = static_cast<uint32_t>(file_.tellg());
 
+    // Frame offsets, so finding a frame is a lookup rather than a sum
+    frameOffsets_.resize(storedFrames + 1);
+    frameOffsets_[0] = dataOffset_;
+    for (uint32_t i = 0; i < storedFrames; ++i) {
+        frameOffsets_[i + 1] = frameOffsets_[i] + (frameSizes_[i] & 0xFFFFFFFC);  // Mask off flags
+    }
+
+    // Keyframes: bit 0 of the frame size
+    keyFrames_.clear();
+    for (uint32_t i = 0; i < frameCount_; ++i) {
+        if (i == 0 || (frameSizes_[i] & 1)) {
+            keyFrames_.push_back(i);
+        }
+    }
+    keyPalettes_.assign(keyFrames_.size(), {});
+
     return true;
 }
 
-float SmackerPlayer::getFrameRate() const {
-    if (frameRateDen_ == 0) return 10.0f;
-    return static_cast<float>(frameRateNum_) / frameRateDen_;
+bool SmackerPlayer::readTrees(const uint8_t* data, size_t size) {
+    static const char* const names[4] = {"MMAP", "MCLR", "FULL", "TYPE"};
+    SmkBitReader bits(data, size);
+
+    for (int i = 0; i < 4; ++i) {
+        trees_[i] = std::make_unique<BigTree>();
+        BigTree& tree = *trees_[i];
+
+        if (!bits.readBit()) {
+            tree.setEmpty();
+            continue;
+        }
+
+        SmkBigTreeReader reader(bits);
+        for (auto& byteTable : reader.byteTables) {
+            std::vector<SmkCode> codes;
+            if (bits.readBit()) {
+                if (!readByteTree(bits, 0, 0, codes)) {
+                    lastError_ = std::string("Invalid SMK ") + names[i] + " byte tree";
+                    return false;
+                }
+                bits.skip(1);
+            } else {
+                codes.push_back({0, 0, 0});
+            }
+            byteTable.build(codes);
+        }
+
+        for (auto& escape : reader.escapes) {
+            escape = static_cast<uint16_t>(bits.read(16));
+        }
+
+        // Same bound on the tree's size as the reference decoder
+        reader.maxEntries = static_cast<uint32_t>(std::min<uint64_t>((bigTreeSizes_[i] + 3ull) / 4 + 4, 1u << 24));
+        if (!reader.read(0, 0)) {
+            lastError_ = std::string("Invalid SMK ") + names[i] + " tree";
+            return false;
+        }
+        bits.skip(1);
+
+        // Escapes that no leaf carries still get a slot of their own
+        for (int e = 0; e < 3; ++e) {
+            if (reader.escapeSlots[e] < 0) {
+                reader.escapeSlots[e] = static_cast<int64_t>(reader.values.size());
+                reader.values.push_back(0);
+            }
+            tree.recent[e] = static_cast<uint32_t>(reader.escapeSlots[e]);
+        }
+        tree.values = std::move(reader.values);
+        tree.table.build(reader.codes);
+    }
+
+    if (bits.overrun()) {
+        lastError_ = "SMK trees are truncated";
+        return false;
+    }
+    return true;
 }
 
 SmackerAudioInfo SmackerPlayer::getAudioInfo(int track) const {
@@ -192,91 +596,239 @@ SmackerAudioInfo SmackerPlayer::getAudioInfo(int track) const {
     return audioInfo_[track];
 }
 
+float SmackerPlayer::getFrameRate() const {
+    if (frameRateDen_ == 0) return 10.0f;
+    return static_cast<float>(frameRateNum_) / frameRateDen_;
+}
+
+double SmackerPlayer::getFrameTime(uint32_t frame) const {
+    return static_cast<double>(frame) / getFrameRate();
+}
+
 bool SmackerPlayer::nextFrame() {
-    if (!isOpen_ || currentFrame_ >= frameCount_) {
+    if (!isOpen_ || isPlaying() || currentFrame_ >= frameCount_) {
         return false;
     }
 
+    // Changes are reported per frame, except that a seek's stay marked
+    // until the frame after it
+    if (clearChanges_) {
+        std::fill(changedBlocks_.begin(), changedBlocks_.end(), 0);
+        paletteChanged_ = false;
+    }
+    clearChanges_ = true;
+
     if (!decodeFrame(currentFrame_)) {
+        lastError_ = decodeError_;
         return false;
     }
+    frameRGBValid_ = false;
 
     currentFrame_++;
     return true;
 }
 
-bool SmackerPlayer::decodeFrame(uint32_t frameIndex) {
-    // Calculate frame offset
-    uint32_t offset = dataOffset_;
-    for (uint32_t i = 0; i < frameIndex; ++i) {
-        offset += frameSizes_[i] & 0xFFFFFFFC;  // Mask off flags
+const std::vector<uint8_t>& SmackerPlayer::getFrameRGB() const {
+    if (!frameRGBValid_) {
+        frameRGB_.resize(frameBuffer_.size() * 3);
+        convertFrame(frameRGB_.data());
+        frameRGBValid_ = true;
+    }
+    return frameRGB_;
+}
+
+const uint8_t* SmackerPlayer::readFrame(uint32_t frameIndex, size_t size) {
+    uint64_t offset = frameOffsets_[frameIndex];
+    if (offset >= readAheadOffset_ && offset + size <= readAheadOffset_ + readAhead_.size()) {
+        return readAhead_.data() + (offset - readAheadOffset_);
     }
 
-    file_.seekg(offset);
+    // Refill with this frame and as many of the following ones as fit
+    uint64_t dataEnd = frameOffsets_.back();
+    size_t length = static_cast<size_t>(std::min<uint64_t>(std::max(size, SMK_READ_AHEAD),
+                                                           dataEnd > offset ? dataEnd - offset : 0));
+    length = std::max(length, size);
+
+    SmkStageTimer timer(stats_ ? &stats_->readMs : nullptr);
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(offset));
     if (!file_) {
-        lastError_ = "Failed to seek to frame";
-        return false;
+        decodeError_ = "Failed to seek to frame";
+        return nullptr;
+    }
+
+    readAhead_.resize(length);
+    file_.read(reinterpret_cast<char*>(readAhead_.data()), length);
+    readAhead_.resize(static_cast<size_t>(file_.gcount()));
+    if (stats_) {
+        stats_->bytesRead += readAhead_.size();
+    }
+    readAheadOffset_ = offset;
+    if (readAhead_.size() < size) {
+        decodeError_ = "Failed to read frame data";
+        return nullptr;
+    }
+    return readAhead_.data();
+}
+
+bool SmackerPlayer::decodeFrame(uint32_t frameIndex) {
+    // Remember the palette going into each keyframe, for seeking back to it
+    auto key = std::lower_bound(keyFrames_.begin(), keyFrames_.end(), frameIndex);
+    if (key != keyFrames_.end() && *key == frameIndex) {
+        auto& saved = keyPalettes_[key - keyFrames_.begin()];
+        if (saved.empty()) {
+            saved = palette_;
+        }
     }
 
     uint32_t frameSize = frameSizes_[frameIndex] & 0xFFFFFFFC;
     uint8_t frameType = frameTypes_[frameIndex];
 
-    std::vector<uint8_t> frameData(frameSize);
-    file_.read(reinterpret_cast<char*>(frameData.data()), frameSize);
-    if (!file_) {
-        lastError_ = "Failed to read frame data";
+    const uint8_t* ptr = readFrame(frameIndex, frameSize);
+    if (!ptr) {
         return false;
     }
-
-    const uint8_t* ptr = frameData.data();
     size_t remaining = frameSize;
 
-    // Decode palette if present
-    if (frameType & 0x01) {
-        uint8_t palSize = *ptr++;
-        remaining--;
-
-        size_t palBytes = (palSize + 1) * 4;
-        if (remaining >= palBytes) {
-            decodePalette(ptr, palBytes);
-            ptr += palBytes;
-            remaining -= palBytes;
+    // Decode palette if present; its size byte counts 4-byte units,
+    // including itself
+    if ((frameType & SMK_FRAME_PALETTE) && remaining > 0) {
+        SmkStageTimer timer(stats_ ? &stats_->paletteMs : nullptr);
+        size_t palBytes = static_cast<size_t>(ptr[0]) * 4;
+        if (palBytes == 0 || palBytes > remaining) {
+            decodeError_ = "Invalid SMK palette chunk";
+            return false;
+        }
+        if (!decodePalette(ptr + 1, palBytes - 1)) {
+            return false;
         }
+        ptr += palBytes;
+        remaining -= palBytes;
     }
 
-    // Decode audio tracks
-    for (int track = 0; track < 7; ++track) {
-        if (frameType & (0x02 << track)) {
-            if (remaining < 4) break;
-            uint32_t audioSize = *reinterpret_cast<const uint32_t*>(ptr);
-            ptr += 4;
-            remaining -= 4;
+    // Decode audio tracks; each size includes its own 4 bytes
+    {
+        SmkStageTimer timer(stats_ ? &stats_->audioMs : nullptr);
+        for (int track = 0; track < 7; ++track) {
+            if (frameType & (0x02 << track)) {
+                if (remaining < 4) break;
+                uint32_t audioSize;
+                std::memcpy(&audioSize, ptr, 4);
+                if (audioSize < 4 || audioSize > remaining) {
+                    decodeError_ = "Invalid SMK audio chunk";
+                    return false;
+                }
 
-            if (remaining >= audioSize - 4) {
-                decodeAudio(ptr, audioSize - 4, track);
-                ptr += audioSize - 4;
-                remaining -= audioSize - 4;
+                if (!decodeAudio(ptr + 4, audioSize - 4, track)) {
+                    return false;
+                }
+                ptr += audioSize;
+                remaining -= audioSize;
             }
         }
     }
 
     // Decode video
-    if (remaining > 0) {
-        decodeVideo(ptr, remaining);
+    SmkStageTimer timer(stats_ ? &stats_->videoMs : nullptr);
+    if (remaining > 0 && !decodeVideo(ptr, remaining)) {
+        return false;
+    }
+
+    if (stats_) {
+        stats_->frames++;
     }
+    return true;
+}
 
+void SmackerPlayer::convertFrame(uint8_t* rgb) const {
     // Convert indexed to RGB
     for (size_t i = 0; i < frameBuffer_.size(); ++i) {
         uint8_t idx = frameBuffer_[i];
-        frameRGB_[i * 3] = palette_[idx * 3];
-        frameRGB_[i * 3 + 1] = palette_[idx * 3 + 1];
-        frameRGB_[i * 3 + 2] = palette_[idx * 3 + 2];
+        rgb[i * 3] = palette_[idx * 3];
+        rgb[i * 3 + 1] = palette_[idx * 3 + 1];
+        rgb[i * 3 + 2] = palette_[idx * 3 + 2];
+    }
+}
+
+void SmackerPlayer::markAllChanged() {
+    std::fill(changedBlocks_.begin(), changedBlocks_.end(), 1);
+    std::fill(textureRows_.begin(), textureRows_.end(), 1);
+    paletteChanged_ = true;
+    clearChanges_ = false;
+    frameRGBValid_ = false;
+}
+
+void SmackerPlayer::updatePaletteLUT() {
+    for (int i = 0; i < 256; ++i) {
+        paletteLUT_[i] = 0xFF000000u | (static_cast<uint32_t>(palette_[i * 3]) << 16) |
+                         (static_cast<uint32_t>(palette_[i * 3 + 1]) << 8) | palette_[i * 3 + 2];
     }
 
+    // Every pixel's color may have changed, not just its index
+    paletteChanged_ = true;
+    std::fill(textureRows_.begin(), textureRows_.end(), 1);
+}
+
+void SmackerPlayer::resetPalette() {
+    // Grayscale until the first palette chunk
+    for (int i = 0; i < 256; ++i) {
+        palette_[i * 3] = static_cast<uint8_t>(i);
+        palette_[i * 3 + 1] = static_cast<uint8_t>(i);
+        palette_[i * 3 + 2] = static_cast<uint8_t>(i);
+    }
+    updatePaletteLUT();
+}
+
+bool SmackerPlayer::restorePalette(size_t keyFrame) {
+    // Start from the closest keyframe whose palette is known (frame 0's
+    // always is) and apply only the palette chunks of the frames after it
+    size_t known = keyFrame;
+    while (keyPalettes_[known].empty()) {
+        known--;
+    }
+    palette_ = keyPalettes_[known];
+    updatePaletteLUT();
+
+    size_t nextKey = known + 1;
+    for (uint32_t frame = keyFrames_[known]; frame < keyFrames_[keyFrame]; ++frame) {
+        if (nextKey < keyFrames_.size() && keyFrames_[nextKey] == frame) {
+            keyPalettes_[nextKey++] = palette_;
+        }
+        if (!(frameTypes_[frame] & SMK_FRAME_PALETTE)) {
+            continue;
+        }
+
+        // The palette chunk comes first; its size byte counts 4-byte units
+        size_t chunkSize = std::min<size_t>(frameSizes_[frame] & 0xFFFFFFFC, 255 * 4);
+        const uint8_t* chunk = readFrame(frame, chunkSize);
+        if (!chunk) {
+            return false;
+        }
+        size_t palBytes = chunkSize > 0 ? static_cast<size_t>(chunk[0]) * 4 : 0;
+        if (palBytes == 0 || palBytes > chunkSize) {
+            decodeError_ = "Invalid SMK palette chunk";
+            return false;
+        }
+        if (!decodePalette(chunk + 1, palBytes - 1)) {
+            return false;
+        }
+    }
+
+    keyPalettes_[keyFrame] = palette_;
     return true;
 }
 
 bool SmackerPlayer::decodePalette(const uint8_t* data, size_t size) {
+    // Copies refer to the palette as it was before this frame
+    uint8_t previous[256 * 3];
+    std::memcpy(previous, palette_.data(), sizeof(previous));
+
+    // 6-bit components are widened by bit replication
+    auto widen = [](uint8_t value) {
+        value &= 0x3F;
+        return static_cast<uint8_t>((value << 2) | (value >> 4));
+    };
+
     size_t i = 0;
     size_t palIdx = 0;
 
@@ -284,58 +836,161 @@ bool SmackerPlayer::decodePalette(const uint8_t* data, size_t size) {
         uint8_t cmd = data[i++];
 
         if (cmd & 0x80) {
-            // Skip entries
-            uint8_t skip = (cmd & 0x7F) + 1;
-            palIdx += skip;
+            // Keep entries
+            palIdx += (cmd & 0x7F) + 1;
         } else if (cmd & 0x40) {
-            // Copy from previous entry
-            uint8_t count = (cmd & 0x3F) + 1;
+            // Copy a range of the previous palette
+            size_t count = (cmd & 0x3F) + 1;
             if (i >= size) break;
-            uint8_t src = data[i++];
-
-            for (uint8_t j = 0; j < count && palIdx < 256; ++j) {
-                if (src < 256) {
-                    palette_[palIdx * 3] = palette_[src * 3];
-                    palette_[palIdx * 3 + 1] = palette_[src * 3 + 1];
-                    palette_[palIdx * 3 + 2] = palette_[src * 3 + 2];
-                }
-                palIdx++;
-                src++;
+            size_t src = data[i++];
+            if (src + count > 256) {
+                updatePaletteLUT();
+                decodeError_ = "Invalid SMK palette chunk";
+                return false;
             }
+
+            count = std::min(count, 256 - palIdx);
+            std::memcpy(&palette_[palIdx * 3], &previous[src * 3], count * 3);
+            palIdx += count;
         } else {
-            // Set RGB values
-            uint8_t count = (cmd & 0x3F) + 1;
-
-            for (uint8_t j = 0; j < count && palIdx < 256 && i + 2 < size; ++j) {
-                // SMK uses 6-bit color values
-                palette_[palIdx * 3] = (data[i] & 0x3F) << 2;
-                palette_[palIdx * 3 + 1] = (data[i + 1] & 0x3F) << 2;
-                palette_[palIdx * 3 + 2] = (data[i + 2] & 0x3F) << 2;
-                i += 3;
-                palIdx++;
-            }
+            // One new entry: this byte is red, green and blue follow
+            if (i + 2 > size) break;
+            palette_[palIdx * 3] = widen(cmd);
+            palette_[palIdx * 3 + 1] = widen(data[i]);
+            palette_[palIdx * 3 + 2] = widen(data[i + 1]);
+            i += 2;
+            palIdx++;
         }
     }
 
+    updatePaletteLUT();
     return true;
 }
 
 bool SmackerPlayer::decodeVideo(const uint8_t* data, size_t size) {
-    // Simplified video decoding - just copy raw data for now
-    // Full Smacker video uses block-based compression with Huffman trees
-
-    // For now, treat it as raw indexed data if size matches
-    size_t expectedSize = static_cast<size_t>(width_) * height_;
-    if (size >= expectedSize) {
-        std::memcpy(frameBuffer_.data(), data, expectedSize);
-        return true;
+    BigTree& mmap = *trees_[0];
+    BigTree& mclr = *trees_[1];
+    BigTree& full = *trees_[2];
+    BigTree& type = *trees_[3];
+    for (const auto& tree : trees_) {
+        tree->resetRecent();
     }
 
-    // Otherwise, this is compressed data
-    // Full implementation would need Smacker's block decoding algorithm
-    // which involves motion blocks, solid blocks, and residual data
+    SmkBitReader bits(data, size);
+    const size_t stride = static_cast<size_t>(width_);
+    const size_t blocksWide = stride / 4;
+    const size_t blocks = blocksWide * (static_cast<size_t>(height_) / 4);
+    uint8_t* pixels = frameBuffer_.data();
+
+    // Top-left pixel of a 4x4 block
+    auto blockAt = [&](size_t block) {
+        return pixels + (block / blocksWide) * stride * 4 + (block % blocksWide) * 4;
+    };
+
+    // Record blocks that are written (all but skipped ones)
+    auto markChanged = [&](size_t first, size_t count) {
+        std::memset(changedBlocks_.data() + first, 1, count);
+        size_t lastRow = (first + count - 1) / blocksWide;
+        for (size_t row = first / blocksWide; row <= lastRow; ++row) {
+            textureRows_[row] = 1;
+        }
+    };
+
+    // Two pixels from the low and high byte of a code
+    auto put2 = [](uint8_t* out, uint16_t value) {
+        out[0] = static_cast<uint8_t>(value);
+        out[1] = static_cast<uint8_t>(value >> 8);
+    };
+
+    size_t block = 0;
+    while (block < blocks) {
+        if (bits.overrun()) {
+            decodeError_ = "SMK video data is truncated";
+            return false;
+        }
+
+        uint16_t code = type.decode(bits);
+        size_t run = std::min<size_t>(SMK_BLOCK_RUNS[(code >> 2) & 0x3F], blocks - block);
+        if ((code & 3) != SMK_BLOCK_SKIP) {
+            markChanged(block, run);
+        }
+
+        switch (code & 3) {
+            case SMK_BLOCK_MONO:
+                for (; run > 0; --run, ++block) {
+                    uint16_t colors = mclr.decode(bits);
+                    uint16_t map = mmap.decode(bits);
+                    uint8_t hi = static_cast<uint8_t>(colors >> 8);
+                    uint8_t lo = static_cast<uint8_t>(colors);
+
+                    uint8_t* out = blockAt(block);
+                    for (int y = 0; y < 4; ++y, out += stride, map >>= 4) {
+                        out[0] = (map & 1) ? hi : lo;
+                        out[1] = (map & 2) ? hi : lo;
+                        out[2] = (map & 4) ? hi : lo;
+                        out[3] = (map & 8) ? hi : lo;
+                    }
+                }
+                break;
+
+            case SMK_BLOCK_FULL: {
+                // Version 4 adds double-size modes: 0 = full, 1 = 2x2 pixels
+                // from two codes, 2 = rows doubled
+                int mode = 0;
+                if (isV4_) {
+                    if (bits.readBit()) {
+                        mode = 1;
+                    } else if (bits.readBit()) {
+                        mode = 2;
+                    }
+                }
+
+                for (; run > 0; --run, ++block) {
+                    uint8_t* out = blockAt(block);
+                    if (mode == 0) {
+                        for (int y = 0; y < 4; ++y, out += stride) {
+                            put2(out + 2, full.decode(bits));
+                            put2(out, full.decode(bits));
+                        }
+                    } else if (mode == 1) {
+                        for (int half = 0; half < 2; ++half) {
+                            uint16_t value = full.decode(bits);
+                            for (int y = 0; y < 2; ++y, out += stride) {
+                                out[0] = out[1] = static_cast<uint8_t>(value);
+                                out[2] = out[3] = static_cast<uint8_t>(value >> 8);
+                            }
+                        }
+                    } else {
+                        for (int half = 0; half < 2; ++half) {
+                            uint16_t right = full.decode(bits);
+                            uint16_t left = full.decode(bits);
+                            for (int y = 0; y < 2; ++y, out += stride) {
+                                put2(out, left);
+                                put2(out + 2, right);
+                            }
+                        }
+                    }
+                }
+                break;
+            }
+
+            case SMK_BLOCK_SKIP:
+                block += run;
+                break;
+
+            case SMK_BLOCK_FILL: {
+                uint8_t color = static_cast<uint8_t>(code >> 8);
+                for (; run > 0; --run, ++block) {
+                    uint8_t* out = blockAt(block);
+                    for (int y = 0; y < 4; ++y, out += stride) {
+                        std::memset(out, color, 4);
+                    }
+                }
+                break;
+            }
+        }
+    }
 
-    // For prototype, just skip (frame remains as previous)
     return true;
 }
 
@@ -363,82 +1018,558 @@ bool SmackerPlayer::decodeAudio(const uint8_t* data, size_t size, int track) {
                 audioBuffers_[track][i] = (static_cast<int16_t>(data[i]) - 128) * 256;
             }
         }
+    } else if (!decodeDPCM(data, size, track)) {
+        audioBuffers_[track].clear();
+        return false;
+    }
+
+    if (track == audioTrack_) {
+        pushAudio(audioBuffers_[track].data(), audioBuffers_[track].size());
+    }
+    return true;
+}
+
+bool SmackerPlayer::decodeDPCM(const uint8_t* data, size_t size, int track) {
+    // Output size in bytes, then the bitstream: a data flag, the stereo and
+    // 16-bit flags, one 8-bit tree per channel and byte (each between two
+    // unused bits), the first sample of each channel (last channel first),
+    // and then the coded differences, channels interleaved
+    if (size < 4) {
+        decodeError_ = "Invalid SMK audio chunk";
+        return false;
+    }
+    uint32_t unpackedSize;
+    std::memcpy(&unpackedSize, data, 4);
+
+    SmkBitReader bits(data + 4, size - 4);
+    if (!bits.readBit()) {
+        return true;    // No samples in this frame
+    }
+
+    const bool stereo = bits.readBit();
+    const bool is16 = bits.readBit();
+    if (stereo != (audioInfo_[track].channels == 2) || is16 != (audioInfo_[track].bitsPerSample == 16)) {
+        decodeError_ = "SMK audio chunk does not match its track format";
+        return false;
+    }
+    if (unpackedSize > SMK_MAX_AUDIO_CHUNK) {
+        decodeError_ = "SMK audio chunk is too large";
+        return false;
+    }
+
+    const unsigned channels = stereo ? 2 : 1;
+    const unsigned treeCount = channels * (is16 ? 2 : 1);
+    SmkHuffTable trees[4];
+    std::vector<SmkCode> codes;
+    for (unsigned i = 0; i < treeCount; ++i) {
+        bits.skip(1);
+        codes.clear();
+        if (!readByteTree(bits, 0, 0, codes)) {
+            decodeError_ = "Invalid SMK audio tree";
+            return false;
+        }
+        bits.skip(1);
+        trees[i].build(codes);
+    }
+
+    size_t samples = is16 ? unpackedSize / 2 : unpackedSize;
+    samples -= samples % channels;
+    std::vector<int16_t>& out = audioBuffers_[track];
+    out.resize(samples);
+    if (samples == 0) {
+        return true;
+    }
+
+    // Predictors wrap around at 8 or 16 bits
+    if (is16) {
+        uint16_t predictor[2];
+        for (int c = static_cast<int>(channels) - 1; c >= 0; --c) {
+            uint16_t value = static_cast<uint16_t>(bits.read(16));
+            predictor[c] = static_cast<uint16_t>((value << 8) | (value >> 8));
+        }
+        for (unsigned c = 0; c < channels; ++c) {
+            out[c] = static_cast<int16_t>(predictor[c]);
+        }
+        for (size_t i = channels; i < samples; ++i) {
+            unsigned c = static_cast<unsigned>(i) & (channels - 1);
+            uint32_t low = trees[c * 2].decode(bits);
+            uint32_t high = trees[c * 2 + 1].decode(bits);
+            predictor[c] = static_cast<uint16_t>(predictor[c] + (low | (high << 8)));
+            out[i] = static_cast<int16_t>(predictor[c]);
+        }
     } else {
-        // DPCM compressed audio
-        // Smacker uses a Huffman-coded DPCM scheme
-        // For prototype, skip compressed audio
+        uint8_t predictor[2];
+        for (int c = static_cast<int>(channels) - 1; c >= 0; --c) {
+            predictor[c] = static_cast<uint8_t>(bits.read(8));
+        }
+        for (unsigned c = 0; c < channels; ++c) {
+            out[c] = static_cast<int16_t>((predictor[c] - 128) * 256);
+        }
+        for (size_t i = channels; i < samples; ++i) {
+            unsigned c = static_cast<unsigned>(i) & (channels - 1);
+            predictor[c] = static_cast<uint8_t>(predictor[c] + trees[c].decode(bits));
+            out[i] = static_cast<int16_t>((predictor[c] - 128) * 256);
+        }
     }
 
+    if (bits.overrun()) {
+        decodeError_ = "SMK audio data is truncated";
+        return false;
+    }
     return true;
 }
 
-std::vector<int16_t> SmackerPlayer::getAudioSamples(int track) {
+SmackerAudioView SmackerPlayer::getAudioSamples(int track) const {
     if (track < 0 || track >= 7) {
         return {};
     }
-    return audioBuffers_[track];
+    return {audioBuffers_[track].data(), audioBuffers_[track].size()};
+}
+
+bool SmackerPlayer::enableAudioStream(int track, int outputRate, int outputChannels) {
+    if (!isOpen_ || isPlaying() || track < 0 || track >= 7 || !audioInfo_[track].hasAudio ||
+        audioInfo_[track].sampleRate == 0 || outputRate <= 0 || outputChannels <= 0) {
+        return false;
+    }
+
+    audioChannels_ = audioInfo_[track].channels;
+    audioRate_ = audioInfo_[track].sampleRate;
+    outputChannels_ = outputChannels;
+    audioStep_ = static_cast<uint32_t>((static_cast<uint64_t>(audioRate_) << 16) / outputRate);
+    audioFraction_ = 0;
+
+    // Two seconds, rounded up to a power of two so positions wrap with a mask
+    size_t capacity = 1024;
+    while (capacity < static_cast<size_t>(audioRate_) * audioChannels_ * 2) {
+        capacity *= 2;
+    }
+    audioRing_.assign(capacity, 0);
+    audioHead_ = 0;
+    audioTail_ = 0;
+    audioFlushTo_ = 0;
+    audioBaseTime_ = getFrameTime(currentFrame_);
+    audioTrack_ = track;
+    return true;
+}
+
+void SmackerPlayer::disableAudioStream() {
+    audioTrack_ = -1;
+    audioRing_.clear();
+}
+
+void SmackerPlayer::pushAudio(const int16_t* samples, size_t count) {
+    const uint64_t capacity = audioRing_.size();
+    uint64_t head = audioHead_.load(std::memory_order_relaxed);
+    uint64_t tail = std::max(audioTail_.load(std::memory_order_acquire),
+                             audioFlushTo_.load(std::memory_order_relaxed));
+
+    // A full ring drops the rest of the chunk rather than wait on the device
+    uint64_t queued = tail < head ? head - tail : 0;
+    count = std::min<uint64_t>(count, capacity - std::min(queued, capacity));
+    count -= count % audioChannels_;
+    for (size_t i = 0; i < count;) {
+        size_t at = static_cast<size_t>((head + i) & (capacity - 1));
+        size_t length = std::min<size_t>(count - i, capacity - at);
+        std::memcpy(audioRing_.data() + at, samples + i, length * sizeof(int16_t));
+        i += length;
+    }
+    audioHead_.store(head + count, std::memory_order_release);
+}
+
+void SmackerPlayer::flushAudio(double time) {
+    if (audioTrack_ < 0) {
+        return;
+    }
+    // The audio thread skips to flushTo on its next read
+    audioBaseTime_.store(time, std::memory_order_relaxed);
+    audioFlushTo_.store(audioHead_.load(std::memory_order_relaxed), std::memory_order_release);
+}
+
+size_t SmackerPlayer::readAudio(int16_t* out, size_t frames) {
+    const size_t outChannels = static_cast<size_t>(outputChannels_);
+    if (audioTrack_ < 0 || audioRing_.empty()) {
+        std::memset(out, 0, frames * outChannels * sizeof(int16_t));
+        return 0;
+    }
+
+    const uint64_t mask = audioRing_.size() - 1;
+    const unsigned inChannels = audioChannels_;
+    const int16_t* ring = audioRing_.data();
+    uint64_t tail = audioTail_.load(std::memory_order_relaxed);
+    uint64_t flushTo = audioFlushTo_.load(std::memory_order_acquire);
+    if (tail < flushTo) {
+        tail = flushTo;
+        audioFraction_ = 0;
+    }
+    uint64_t head = audioHead_.load(std::memory_order_acquire);
+
+    // Linear interpolation between the current and the next source frame.
+    // A sample needs both of those, and the frames it steps over (several
+    // when the source rate is over twice the device rate), to be queued,
+    // so tail never passes head.
+    size_t written = 0;
+    for (; written < frames && tail < head; ++written) {
+        uint64_t advance = (static_cast<uint64_t>(audioFraction_) + audioStep_) >> 16;
+        if (head - tail < std::max<uint64_t>(2, advance + 1) * inChannels) {
+            break;
+        }
+
+        int32_t left0 = ring[tail & mask];
+        int32_t right0 = ring[(tail + inChannels - 1) & mask];
+        int32_t left1 = ring[(tail + inChannels) & mask];
+        int32_t right1 = ring[(tail + 2 * inChannels - 1) & mask];
+        // A 16-bit difference times a 16.16 fraction can overflow 32 bits
+        int64_t fraction = static_cast<int64_t>(audioFraction_);
+        int32_t left = left0 + static_cast<int32_t>(((left1 - left0) * fraction) >> 16);
+        int32_t right = right0 + static_cast<int32_t>(((right1 - right0) * fraction) >> 16);
+
+        if (outChannels == 1) {
+            out[0] = static_cast<int16_t>((left + right) >> 1);
+        } else {
+            out[0] = static_cast<int16_t>(left);
+            out[1] = static_cast<int16_t>(right);
+            for (size_t c = 2; c < outChannels; ++c) {
+                out[c] = 0;
+            }
+        }
+        out += outChannels;
+
+        audioFraction_ = (audioFraction_ + audioStep_) & 0xFFFF;
+        tail += advance * inChannels;
+    }
+    audioTail_.store(tail, std::memory_order_release);
+
+    std::memset(out, 0, (frames - written) * outChannels * sizeof(int16_t));
+    return written;
+}
+
+void SmackerPlayer::audioCallback(void* player, uint8_t* stream, int bytes) {
+    SmackerPlayer* self = static_cast<SmackerPlayer*>(player);
+    size_t frameBytes = static_cast<size_t>(self->outputChannels_) * sizeof(int16_t);
+    self->readAudio(reinterpret_cast<int16_t*>(stream), static_cast<size_t>(bytes) / frameBytes);
+}
+
+double SmackerPlayer::getAudioClock() const {
+    if (audioTrack_ < 0) {
+        return 0.0;
+    }
+    uint64_t flushTo = audioFlushTo_.load(std::memory_order_acquire);
+    uint64_t tail = std::min(audioTail_.load(std::memory_order_acquire),
+                             audioHead_.load(std::memory_order_acquire));
+    double played = tail > flushTo ? static_cast<double>(tail - flushTo) : 0.0;
+    return audioBaseTime_.load(std::memory_order_relaxed) + played / (static_cast<double>(audioRate_) * audioChannels_);
 }
 
 void SmackerPlayer::rewind() {
+    if (isPlaying()) {
+        return;
+    }
     currentFrame_ = 0;
-    // Reset frame buffer
+    // Reset frame buffer and palette
     std::fill(frameBuffer_.begin(), frameBuffer_.end(), 0);
+    resetPalette();
+    markAllChanged();
+    flushAudio(0.0);
 }
 
-bool SmackerPlayer::seekToFrame(uint32_t frame) {
-    if (frame >= frameCount_) {
+bool SmackerPlayer::seekToFrame(uint32_t frame, SmackerSeekMode mode) {
+    if (!isOpen_ || isPlaying() || frame >= frameCount_) {
         return false;
     }
 
-    // For accurate seeking, we need to decode from beginning
-    // (due to delta compression)
-    if (frame < currentFrame_) {
-        rewind();
+    // Nearest keyframe at or before the frame
+    size_t key = std::upper_bound(keyFrames_.begin(), keyFrames_.end(), frame) - keyFrames_.begin() - 1;
+    uint32_t target = (mode == SmackerSeekMode::KeyFrame) ? keyFrames_[key] : frame;
+
+    // Carry on from the current frame if it is already past that keyframe;
+    // otherwise jump to the keyframe with the palette it expects
+    if (currentFrame_ < keyFrames_[key] || currentFrame_ > target) {
+        if (!restorePalette(key)) {
+            lastError_ = decodeError_;
+            return false;
+        }
+        currentFrame_ = keyFrames_[key];
     }
 
-    while (currentFrame_ < frame) {
-        if (!nextFrame()) {
+    while (currentFrame_ < target) {
+        if (!decodeFrame(currentFrame_)) {
+            lastError_ = decodeError_;
             return false;
         }
+        currentFrame_++;
     }
 
+    // Audio of the frames decoded on the way is not played
+    markAllChanged();
+    flushAudio(getFrameTime(currentFrame_));
     return true;
 }
 
+bool SmackerPlayer::startPlayback(size_t ringFrames, SmackerPixelFormat format) {
+    if (!isOpen_ || isPlaying()) {
+        return false;
+    }
+
+    // Every slot is allocated up front; the thread only overwrites them
+    ring_.resize(std::max<size_t>(ringFrames, 2));
+    for (auto& slot : ring_) {
+        slot.format = format;
+        if (format == SmackerPixelFormat::ARGB8888) {
+            slot.argb.resize(frameBuffer_.size());
+            slot.indexed.clear();
+        } else {
+            slot.indexed.resize(frameBuffer_.size());
+            slot.argb.clear();
+        }
+    }
+    ringFormat_ = format;
+
+    ringHead_ = 0;
+    ringTail_ = 0;
+    producerWaiting_ = false;
+    stopDecode_ = false;
+    decodeDone_ = false;
+    droppedFrames_ = 0;
+    decodeNext_ = currentFrame_;
+    decodeError_.clear();
+
+    decodeThread_ = std::thread(&SmackerPlayer::playbackLoop, this);
+    return true;
+}
+
+void SmackerPlayer::stopPlayback() {
+    if (!decodeThread_.joinable()) {
+        return;
+    }
+
+    stopDecode_ = true;
+    {
+        std::lock_guard<std::mutex> lock(ringMutex_);
+        ringSpace_.notify_one();
+    }
+    decodeThread_.join();
+
+    // Only the thread wrote it while playing
+    if (!decodeError_.empty()) {
+        lastError_ = decodeError_;
+    }
+
+    currentFrame_ = decodeNext_;
+    ringHead_ = 0;
+    ringTail_ = 0;
+
+    // The texture and any compositor last saw a ring frame
+    markAllChanged();
+}
+
+void SmackerPlayer::playbackLoop() {
+    const uint64_t slots = ring_.size();
+
+    while (!stopDecode_ && decodeNext_ < frameCount_) {
+        uint64_t head = ringHead_.load(std::memory_order_relaxed);
+
+        // Sleep only while the ring is full. The consumer notifies without
+        // taking the lock, so a missed wakeup costs at most one timeout.
+        if (head - ringTail_.load(std::memory_order_acquire) >= slots) {
+            producerWaiting_.store(true);
+            std::unique_lock<std::mutex> lock(ringMutex_);
+            ringSpace_.wait_for(lock, std::chrono::milliseconds(2), [&] {
+                return stopDecode_ || head - ringTail_.load(std::memory_order_acquire) < slots;
+            });
+            producerWaiting_.store(false);
+            continue;
+        }
+
+        if (!decodeFrame(decodeNext_)) {
+            break;
+        }
+
+        SmackerFrame& slot = ring_[head % slots];
+        slot.index = decodeNext_;
+        slot.time = getFrameTime(decodeNext_);
+        if (ringFormat_ == SmackerPixelFormat::ARGB8888) {
+            expandPalette8(frameBuffer_.data(), slot.argb.data(), frameBuffer_.size(), paletteLUT_);
+        } else {
+            std::memcpy(slot.indexed.data(), frameBuffer_.data(), frameBuffer_.size());
+            std::memcpy(slot.palette, paletteLUT_, sizeof(slot.palette));
+        }
+        decodeNext_++;
+
+        ringHead_.store(head + 1, std::memory_order_release);
+    }
+
+    decodeDone_.store(true, std::memory_order_release);
+}
+
+const SmackerFrame* SmackerPlayer::acquireFrame(double time) {
+    if (ring_.empty()) {
+        return nullptr;
+    }
+
+    const uint64_t slots = ring_.size();
+    uint64_t tail = ringTail_.load(std::memory_order_relaxed);
+    uint64_t head = ringHead_.load(std::memory_order_acquire);
+    if (tail == head || ring_[tail % slots].time > time) {
+        return nullptr;
+    }
+
+    // Skip to the newest frame that is already due
+    uint64_t first = tail;
+    while (head - tail > 1 && ring_[(tail + 1) % slots].time <= time) {
+        tail++;
+    }
+    if (tail != first) {
+        droppedFrames_.fetch_add(static_cast<uint32_t>(tail - first), std::memory_order_relaxed);
+        ringTail_.store(tail, std::memory_order_release);
+        if (producerWaiting_.load()) {
+            ringSpace_.notify_one();
+        }
+    }
+
+    return &ring_[tail % slots];
+}
+
+const SmackerFrame* SmackerPlayer::acquireFrame() {
+    if (audioTrack_ < 0 || ring_.empty()) {
+        return nullptr;
+    }
+
+    // If the audio has run dry and no more is coming (decoding has ended,
+    // or is waiting for frames to be taken), the clock has stopped; hand
+    // out the next frame so video doesn't stall on it
+    double time = getAudioClock();
+    uint64_t tail = ringTail_.load(std::memory_order_relaxed);
+    uint64_t head = ringHead_.load(std::memory_order_acquire);
+    uint64_t audioHead = audioHead_.load(std::memory_order_acquire);
+    uint64_t audioTail = std::max(audioTail_.load(std::memory_order_acquire),
+                                  audioFlushTo_.load(std::memory_order_acquire));
+    uint64_t audioQueued = audioTail < audioHead ? audioHead - audioTail : 0;
+    if (tail != head && audioQueued < 2u * audioChannels_ &&
+        (decodeDone_.load(std::memory_order_acquire) || head - tail == ring_.size())) {
+        time = std::max(time, ring_[tail % ring_.size()].time);
+    }
+    return acquireFrame(time);
+}
+
+void SmackerPlayer::releaseFrame(const SmackerFrame* frame) {
+    if (!frame || ring_.empty()) {
+        return;
+    }
+
+    uint64_t tail = ringTail_.load(std::memory_order_relaxed);
+    if (frame != &ring_[tail % ring_.size()] || tail == ringHead_.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    ringTail_.store(tail + 1, std::memory_order_release);
+    if (producerWaiting_.load()) {
+        ringSpace_.notify_one();
+    }
+}
+
+bool SmackerPlayer::isPlaybackFinished() const {
+    return decodeDone_.load(std::memory_order_acquire) &&
+           ringTail_.load(std::memory_order_acquire) == ringHead_.load(std::memory_order_acquire);
+}
+
 SDL_Texture* SmackerPlayer::getFrameTexture(SDL_Renderer* renderer) {
 #ifdef SDL_h_
-    if (!renderer) return nullptr;
+    if (!renderer || !isOpen_ || isPlaying()) return nullptr;
 
-    // Create or recreate texture if needed
     if (!texture_) {
-        texture_ = SDL_CreateTexture(renderer,
-                                     SDL_PIXELFORMAT_RGB24,
-                                     SDL_TEXTUREACCESS_STREAMING,
-                                     width_, height_);
-        if (!texture_) {
-            lastError_ = "Failed to create SDL texture";
+        if (!createTexture(renderer)) {
             return nullptr;
         }
+        std::fill(textureRows_.begin(), textureRows_.end(), 1);
     }
 
-    // Update texture with current frame
+    // Lock each band of changed block rows and expand its indices in place.
+    // Locked pixels are write-only, so a band is always written in full.
+    const size_t rows = textureRows_.size();
+    for (size_t row = 0; row < rows;) {
+        if (!textureRows_[row]) {
+            row++;
+            continue;
+        }
+        size_t end = row;
+        while (end < rows && textureRows_[end]) {
+            textureRows_[end++] = 0;
+        }
+
+        int top = static_cast<int>(row) * 4;
+        int bottom = std::min(static_cast<int>(end) * 4, height_);
+        SDL_Rect band = {0, top, width_, bottom - top};
+        void* pixels;
+        int pitch;
+        if (SDL_LockTexture(texture_, &band, &pixels, &pitch) != 0) {
+            std::fill(textureRows_.begin() + row, textureRows_.begin() + end, 1);
+            lastError_ = "Failed to lock SDL texture";
+            return texture_;
+        }
+
+        uint8_t* dst = static_cast<uint8_t*>(pixels);
+        for (int y = top; y < bottom; ++y, dst += pitch) {
+            expandPalette8(frameBuffer_.data() + static_cast<size_t>(y) * width_,
+                           reinterpret_cast<uint32_t*>(dst), width_, paletteLUT_);
+        }
+        SDL_UnlockTexture(texture_);
+        row = end;
+    }
+
+    return texture_;
+#else
+    (void)renderer;
+    lastError_ = "SDL2 not available";
+    return nullptr;
+#endif
+}
+
+SDL_Texture* SmackerPlayer::getFrameTexture(SDL_Renderer* renderer, const SmackerFrame& frame) {
+#ifdef SDL_h_
+    if (!renderer || !createTexture(renderer)) return nullptr;
+
     void* pixels;
     int pitch;
     if (SDL_LockTexture(texture_, nullptr, &pixels, &pitch) == 0) {
         uint8_t* dst = static_cast<uint8_t*>(pixels);
-        for (int y = 0; y < height_; ++y) {
-            std::memcpy(dst + y * pitch,
-                        frameRGB_.data() + y * width_ * 3,
-                        width_ * 3);
+        const size_t width = static_cast<size_t>(width_);
+        for (int y = 0; y < height_; ++y, dst += pitch) {
+            uint32_t* line = reinterpret_cast<uint32_t*>(dst);
+            if (frame.format == SmackerPixelFormat::ARGB8888) {
+                std::memcpy(line, frame.argb.data() + y * width, width * 4);
+            } else {
+                expandPalette8(frame.indexed.data() + y * width, line, width, frame.palette);
+            }
         }
         SDL_UnlockTexture(texture_);
     }
 
     return texture_;
 #else
+    (void)renderer;
+    (void)frame;
     lastError_ = "SDL2 not available";
     return nullptr;
 #endif
 }
 
+bool SmackerPlayer::createTexture(SDL_Renderer* renderer) {
+#ifdef SDL_h_
+    if (!texture_) {
+        texture_ = SDL_CreateTexture(renderer,
+                                     SDL_PIXELFORMAT_ARGB8888,
+                                     SDL_TEXTUREACCESS_STREAMING,
+                                     width_, height_);
+        if (!texture_) {
+            lastError_ = "Failed to create SDL texture";
+            return false;
+        }
+    }
+    return true;
+#else
+    (void)renderer;
+    return false;
+#endif
+}
+
 } // namespace opengg
@@ -0,0 +1,264 @@
+#include "span_sprite.h"
+#include "palette.h"
+#include <algorithm>
+#include <cstring>
+
+namespace opengg {
+
+// Largest width a span offset can address
+static constexpr int MAX_SPAN_WIDTH = UINT16_MAX;
+
+// Turns decoded pixels into spans as a decoder produces them: literal spans
+// are split around index 0, runs of index 0 only move the position, and
+// spans that touch are merged. In wrap mode output flows on to the next row
+// at the right edge (flat streams); otherwise it is dropped past the edge
+// until the stream ends the row.
+class SpanBuilder {
+public:
+    SpanBuilder(SpanSprite& out, int width, int height, bool wrap)
+        : out_(out), width_(static_cast<size_t>(width)), height_(static_cast<size_t>(height)), wrap_(wrap) {
+        out_.width = width;
+        out_.height = height;
+        out_.rowSpans.assign(height_ + 1, 0);
+        out_.rowPixels.assign(height_ + 1, 0);
+        out_.spans.clear();
+        out_.pixels.clear();
+    }
+
+    bool done() const { return y_ >= height_; }
+
+    void literal(const uint8_t* src, size_t count) {
+        while (count > 0 && !done()) {
+            size_t taken = take(count);
+            for (size_t i = 0; i < taken;) {
+                // Skip transparent pixels, then emit the opaque stretch after them
+                while (i < taken && src[i] == 0) {
+                    i++;
+                }
+                size_t start = i;
+                while (i < taken && src[i] != 0) {
+                    i++;
+                }
+                if (i > start) {
+                    addSpan(x_ + start, i - start);
+                    out_.pixels.insert(out_.pixels.end(), src + start, src + i);
+                }
+            }
+            if (!advance(count, taken)) {
+                return;
+            }
+            src += taken;
+            count -= taken;
+        }
+    }
+
+    void run(uint8_t value, size_t count) {
+        while (count > 0 && !done()) {
+            size_t taken = take(count);
+            if (value != 0 && taken > 0) {
+                addSpan(x_, taken);
+                out_.pixels.insert(out_.pixels.end(), taken, value);
+            }
+            if (!advance(count, taken)) {
+                return;
+            }
+            count -= taken;
+        }
+    }
+
+    void endRow() {
+        if (done()) {
+            return;
+        }
+        y_++;
+        x_ = 0;
+        out_.rowSpans[y_] = static_cast<uint32_t>(out_.spans.size());
+        out_.rowPixels[y_] = static_cast<uint32_t>(out_.pixels.size());
+    }
+
+    // Rows the stream never reached are empty
+    void finish() {
+        for (size_t row = y_ + 1; row <= height_; ++row) {
+            out_.rowSpans[row] = static_cast<uint32_t>(out_.spans.size());
+            out_.rowPixels[row] = static_cast<uint32_t>(out_.pixels.size());
+        }
+    }
+
+private:
+    // Pixels of count that land inside the current row
+    size_t take(size_t count) const {
+        return x_ < width_ ? std::min(count, width_ - x_) : 0;
+    }
+
+    // Move past count pixels of which taken were inside the row; returns
+    // false once the rest is to be dropped
+    bool advance(size_t count, size_t taken) {
+        if (!wrap_) {
+            x_ += count;
+            return false;
+        }
+        x_ += taken;
+        if (x_ == width_) {
+            endRow();
+        }
+        return true;
+    }
+
+    void addSpan(size_t x, size_t length) {
+        // Extend the previous span if it is in this row and ends at x
+        if (out_.spans.size() > out_.rowSpans[y_]) {
+            SpanSprite::Span& last = out_.spans.back();
+            if (last.x + static_cast<size_t>(last.length) == x) {
+                last.length = static_cast<uint16_t>(last.length + length);
+                return;
+            }
+        }
+        out_.spans.push_back({static_cast<uint16_t>(x), static_cast<uint16_t>(length)});
+    }
+
+    SpanSprite& out_;
+    size_t width_;
+    size_t height_;
+    bool wrap_;
+    size_t x_ = 0;
+    size_t y_ = 0;
+};
+
+static bool validSize(int width, int height) {
+    return width > 0 && height > 0 && width <= MAX_SPAN_WIDTH;
+}
+
+size_t SpanSprite::getMemoryUsage() const {
+    return sizeof(SpanSprite) + (rowSpans.size() + rowPixels.size()) * sizeof(uint32_t) +
+           spans.size() * sizeof(Span) + pixels.size();
+}
+
+bool compileSpans(const uint8_t* indexed, int width, int height, SpanSprite& out) {
+    if (!validSize(width, height)) {
+        return false;
+    }
+
+    SpanBuilder builder(out, width, height, true);
+    builder.literal(indexed, static_cast<size_t>(width) * height);
+    builder.finish();
+    return true;
+}
+
+bool compileSpansEscapeFF(const uint8_t* src, size_t srcSize, int width, int height, SpanSprite& out) {
+    if (!validSize(width, height)) {
+        return false;
+    }
+
+    // Same stream walk as decodeRLEEscapeFF
+    SpanBuilder builder(out, width, height, true);
+    size_t in = 0;
+    while (in < srcSize && !builder.done()) {
+        const void* escape = std::memchr(src + in, 0xFF, srcSize - in);
+        size_t literalEnd = escape ? static_cast<size_t>(static_cast<const uint8_t*>(escape) - src)
+                                   : srcSize;
+        if (literalEnd + 2 >= srcSize) {
+            literalEnd = srcSize;
+        }
+
+        if (literalEnd > in) {
+            builder.literal(src + in, literalEnd - in);
+            in = literalEnd;
+            continue;
+        }
+
+        size_t count = src[in + 2];
+        builder.run(src[in + 1], count == 0 ? 1 : count);
+        in += 3;
+    }
+    builder.finish();
+    return true;
+}
+
+bool compileSpansRows(const uint8_t* src, size_t srcSize, int width, int height, SpanSprite& out) {
+    if (!validSize(width, height)) {
+        return false;
+    }
+
+    // Same stream walk as decodeRLERows
+    SpanBuilder builder(out, width, height, false);
+    size_t in = 0;
+    while (in < srcSize && !builder.done()) {
+        uint8_t cmd = src[in];
+
+        if (cmd == 0x00) {
+            builder.endRow();
+            in++;
+            continue;
+        }
+
+        if (cmd == 0xFF && in + 2 < srcSize) {
+            builder.run(src[in + 1], src[in + 2] + 1u);
+            in += 3;
+            continue;
+        }
+
+        size_t end = in + 1;
+        while (end < srcSize && src[end] != 0x00 && (src[end] != 0xFF || end + 2 >= srcSize)) {
+            end++;
+        }
+        builder.literal(src + in, end - in);
+        in = end;
+    }
+    builder.finish();
+    return true;
+}
+
+// Walk the visible part of every span, clipped to the target, and hand each
+// to draw(dstPixel, srcIndices, count)
+template <typename Pixel, typename Draw>
+static void blitSpans(const SpanSprite& sprite, Pixel* dst, int pitch, int dstWidth, int dstHeight,
+                      int x, int y, Draw draw) {
+    int firstRow = std::max(0, -y);
+    int lastRow = std::min(sprite.height, dstHeight - y);
+
+    for (int row = firstRow; row < lastRow; ++row) {
+        Pixel* line = reinterpret_cast<Pixel*>(reinterpret_cast<uint8_t*>(dst) +
+                                               static_cast<ptrdiff_t>(y + row) * pitch);
+        const uint8_t* indices = sprite.pixels.data() + sprite.rowPixels[row];
+
+        for (uint32_t i = sprite.rowSpans[row]; i < sprite.rowSpans[row + 1]; ++i) {
+            const SpanSprite::Span& span = sprite.spans[i];
+            const uint8_t* src = indices;
+            indices += span.length;
+
+            int left = x + span.x;
+            int length = span.length;
+            if (left >= dstWidth) {
+                break;      // Spans are in x order
+            }
+            if (left < 0) {
+                if (left + length <= 0) {
+                    continue;
+                }
+                src -= left;
+                length += left;
+                left = 0;
+            }
+            length = std::min(length, dstWidth - left);
+            draw(line + left, src, static_cast<size_t>(length));
+        }
+    }
+}
+
+void blitSpans8(const SpanSprite& sprite, uint8_t* dst, int pitch, int dstWidth, int dstHeight,
+                int x, int y) {
+    blitSpans(sprite, dst, pitch, dstWidth, dstHeight, x, y,
+              [](uint8_t* out, const uint8_t* src, size_t count) {
+                  std::memcpy(out, src, count);
+              });
+}
+
+void blitSpans32(const SpanSprite& sprite, uint32_t* dst, int pitch, int dstWidth, int dstHeight,
+                 int x, int y, const uint32_t lut[256]) {
+    blitSpans(sprite, dst, pitch, dstWidth, dstHeight, x, y,
+              [lut](uint32_t* out, const uint8_t* src, size_t count) {
+                  expandPalette8(src, out, count, lut);
+              });
+}
+
+} // namespace opengg
@@ -1,9 +1,20 @@
 #include "formats/sprite_format.h"
+#include "decompress.h"
+#include "palette.h"
 #include <fstream>
 #include <cstring>
 
 namespace opengg {
 
+SpriteDecoder::SpriteDecoder() {
+    // Grayscale until a palette is loaded, as getPaletteColor() reports
+    for (uint32_t i = 0; i < 256; ++i) {
+        palette_[i][0] = palette_[i][1] = palette_[i][2] = static_cast<uint8_t>(i);
+        palette_[i][3] = 0;
+    }
+    buildPaletteLUT(&palette_[0][0], 256, lut_);
+}
+
 bool SpriteDecoder::loadPalette(const std::string& gamePath) {
     // Try to load from AUTO256.BMP
     std::string palettePath = gamePath + "/INSTALL/AUTO256.BMP";
@@ -24,6 +35,9 @@ bool SpriteDecoder::loadPalette(const std::string& gamePath) {
     file.read(reinterpret_cast<char*>(palette_), 1024);
 
     paletteLoaded_ = file.good();
+    if (paletteLoaded_) {
+        buildPaletteLUT(&palette_[0][0], 256, lut_);
+    }
     return paletteLoaded_;
 }
 
@@ -48,23 +62,16 @@ std::vector<uint8_t> SpriteDecoder::getRawGraphics(const std::string& datFile,
 }
 
 std::vector<uint32_t> SpriteDecoder::convertToRGBA(const std::vector<uint8_t>& indexed) {
-    std::vector<uint32_t> rgba;
-    rgba.reserve(indexed.size());
-
-    for (uint8_t idx : indexed) {
-        // Palette is in BGRA format, output as RGBA
-        uint8_t b = palette_[idx][0];
-        uint8_t g = palette_[idx][1];
-        uint8_t r = palette_[idx][2];
-        // Alpha is always 255 (fully opaque)
-        // Pack as 0xAARRGGBB
-        uint32_t pixel = 0xFF000000 | (r << 16) | (g << 8) | b;
-        rgba.push_back(pixel);
-    }
-
+    std::vector<uint32_t> rgba(indexed.size());
+    convertToRGBA(indexed.data(), rgba.data(), indexed.size());
     return rgba;
 }
 
+void SpriteDecoder::convertToRGBA(const uint8_t* indexed, uint32_t* dst, size_t count) const {
+    // Opaque 0xAARRGGBB through the cached lookup table
+    expandPalette8(indexed, dst, count, lut_);
+}
+
 void SpriteDecoder::getPaletteColor(uint8_t index, uint8_t& r, uint8_t& g, uint8_t& b) const {
     if (!paletteLoaded_) {
         r = g = b = index; // Grayscale fallback
@@ -78,32 +85,9 @@ void SpriteDecoder::getPaletteColor(uint8_t index, uint8_t& r, uint8_t& g, uint8
 
 std::vector<uint8_t> SpriteDecoder::decompressRLE(const uint8_t* data, size_t dataSize,
                                                    size_t expectedPixels) {
-    std::vector<uint8_t> pixels;
-    pixels.reserve(expectedPixels);
-
-    size_t i = 0;
-    while (pixels.size() < expectedPixels && i < dataSize) {
-        if (data[i] == 0xFF && i + 2 < dataSize) {
-            // RLE: FF <byte> <count> - repeat byte count times
-            uint8_t byte = data[i + 1];
-            uint8_t count = data[i + 2];
-            if (count == 0) count = 1;  // Safety
-
-            for (int j = 0; j < count && pixels.size() < expectedPixels; ++j) {
-                pixels.push_back(byte);
-            }
-            i += 3;
-        } else {
-            // Literal byte
-            pixels.push_back(data[i]);
-            i++;
-        }
-    }
-
-    // Pad with zeros if we didn't get enough pixels
-    while (pixels.size() < expectedPixels) {
-        pixels.push_back(0);
-    }
+    // Pad with zeros if the data runs out early
+    std::vector<uint8_t> pixels(expectedPixels, 0);
+    decodeRLEEscapeFF(data, dataSize, pixels.data(), expectedPixels);
 
     return pixels;
 }
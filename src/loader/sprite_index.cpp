@@ -0,0 +1,388 @@
+#include "sprite_index.h"
+#include "ne_resource.h"
+#include "mapped_file.h"
+#include "decompress.h"
+#include "span_sprite.h"
+#include "formats/sprite_format.h"
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <unordered_set>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+namespace opengg {
+
+static constexpr char SPRITE_INDEX_MAGIC[4] = {'O', 'G', 'S', 'I'};
+static constexpr uint32_t SPRITE_INDEX_VERSION = 1;
+
+// Sprite table layout: version (1), frame count, reserved bytes, then the
+// frame offsets (relative to the table) from byte 14
+static constexpr uint32_t SPRITE_TABLE_OFFSETS = 14;
+
+// CUSTOM_32514 palettes: 256 entries of 00 R 00 G 00 B
+static constexpr uint32_t PALETTE_RESOURCE_SIZE = 1536;
+
+static int64_t getModifiedTime(const std::string& path) {
+    std::error_code ec;
+    auto time = fs::last_write_time(path, ec);
+    if (ec) {
+        return 0;
+    }
+    return static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+static uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static uint32_t readU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// Longest row and row count of an encoded frame (see decodeRLERows).
+// Trailing empty rows are dropped: the last frame of a table runs into the
+// resource's alignment padding, which reads as row terminators.
+static void measureFrame(const uint8_t* src, size_t size, uint16_t& width, uint16_t& height) {
+    size_t longest = 0;
+    size_t row = 0;
+    size_t rows = 0;
+    size_t lastRow = 0;     // Rows up to and including the last non-empty one
+    for (size_t i = 0; i < size;) {
+        uint8_t cmd = src[i++];
+        if (cmd == 0xFF && i + 1 < size) {
+            row += src[i + 1] + 1u;
+            i += 2;
+        } else if (cmd == 0x00) {
+            if (row > 0) {
+                longest = std::max(longest, row);
+                lastRow = rows + 1;
+            }
+            row = 0;
+            rows++;
+        } else {
+            row++;
+        }
+    }
+    if (row > 0) {
+        longest = std::max(longest, row);
+        lastRow = rows + 1;
+    }
+    rows = lastRow;
+    width = static_cast<uint16_t>(std::min<size_t>(longest, UINT16_MAX));
+    height = static_cast<uint16_t>(std::min<size_t>(rows, UINT16_MAX));
+}
+
+// Sprite table IDs named by the ASEQ table (empty if the file has none)
+static std::vector<uint16_t> readASEQTable(const MappedFile& file) {
+    std::vector<uint16_t> ids;
+    for (uint32_t offset = GIZMO_ASEQ_TABLE_OFFSET;; offset += sizeof(ASEQEntry)) {
+        const uint8_t* record = file.at(offset, sizeof(ASEQEntry));
+        ASEQEntry entry;
+        if (!record) {
+            break;
+        }
+        std::memcpy(&entry, record, sizeof(entry));
+        if (std::memcmp(entry.marker, "ASEQ", 4) != 0) {
+            break;
+        }
+        if (entry.resType == RES_TYPE_SPRITE_INDEX) {
+            ids.push_back(entry.seqId);
+        }
+    }
+    return ids;
+}
+
+// Palette resource IDs named by the LT table (empty if the file has none)
+static std::unordered_set<uint16_t> readLTTable(const MappedFile& file) {
+    std::unordered_set<uint16_t> ids;
+    for (uint32_t offset = GIZMO_LT_TABLE_OFFSET;; offset += sizeof(LTEntry)) {
+        const uint8_t* record = file.at(offset, sizeof(LTEntry));
+        LTEntry entry;
+        if (!record) {
+            break;
+        }
+        std::memcpy(&entry, record, sizeof(entry));
+        if (entry.marker[0] != 'L' || entry.marker[1] != 'T') {
+            break;
+        }
+        if (entry.resType == RES_TYPE_SPRITE_META) {
+            ids.insert(entry.resId);
+        }
+    }
+    return ids;
+}
+
+SpriteIndex::SpriteIndex() = default;
+SpriteIndex::~SpriteIndex() = default;
+
+void SpriteIndex::clear() {
+    datPath_.clear();
+    sourceSize_ = 0;
+    sourceModifiedTime_ = 0;
+    mapping_.reset();
+    animations_.clear();
+    frames_.clear();
+}
+
+bool SpriteIndex::mapSource(const std::string& datPath) {
+    auto mapping = std::make_unique<MappedFile>();
+    if (!mapping->open(datPath)) {
+        lastError_ = "Failed to map " + datPath + ": " + mapping->getLastError();
+        return false;
+    }
+
+    datPath_ = datPath;
+    sourceSize_ = mapping->size();
+    sourceModifiedTime_ = getModifiedTime(datPath);
+    mapping_ = std::move(mapping);
+    return true;
+}
+
+bool SpriteIndex::build(const std::string& datPath) {
+    clear();
+
+    NEResourceExtractor ne;
+    if (!ne.open(datPath)) {
+        lastError_ = ne.getLastError();
+        return false;
+    }
+    if (!mapSource(datPath)) {
+        return false;
+    }
+
+    // Animations named by the ASEQ table, or every sprite table
+    std::vector<uint16_t> ids = readASEQTable(*mapping_);
+    if (ids.empty()) {
+        for (const Resource& res : ne.listResourcesByType(RES_TYPE_SPRITE_INDEX)) {
+            ids.push_back(res.id);
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    std::unordered_set<uint16_t> paletteIds = readLTTable(*mapping_);
+
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> sorted;
+    for (uint16_t id : ids) {
+        const Resource* res = ne.findResource(RES_TYPE_SPRITE_INDEX, id);
+        const uint8_t* table = res ? mapping_->at(res->offset, res->size) : nullptr;
+        if (!table || res->size < SPRITE_TABLE_OFFSETS) {
+            continue;
+        }
+
+        uint16_t version = readU16(table);
+        uint16_t count = readU16(table + 2);
+        uint32_t tableEnd = SPRITE_TABLE_OFFSETS + count * 4u;
+        if (version != 1 || count == 0 || tableEnd > res->size) {
+            continue;
+        }
+
+        offsets.resize(count);
+        for (uint16_t i = 0; i < count; ++i) {
+            offsets[i] = readU32(table + SPRITE_TABLE_OFFSETS + i * 4u);
+        }
+
+        // A frame runs up to the next frame in file order
+        sorted = offsets;
+        std::sort(sorted.begin(), sorted.end());
+
+        SpriteAnimation animation;
+        animation.id = id;
+        animation.paletteId = 0;
+        animation.firstFrame = static_cast<uint32_t>(frames_.size());
+        animation.frameCount = 0;
+
+        const Resource* palette = ne.findResource(RES_TYPE_SPRITE_META, id);
+        bool listed = paletteIds.empty() || paletteIds.count(id);
+        if (listed && palette && palette->size == PALETTE_RESOURCE_SIZE) {
+            animation.paletteId = id;
+        }
+
+        for (uint16_t i = 0; i < count; ++i) {
+            uint32_t start = offsets[i];
+            if (start < tableEnd || start >= res->size) {
+                continue;
+            }
+            auto next = std::upper_bound(sorted.begin(), sorted.end(), start);
+            uint32_t end = (next != sorted.end() && *next < res->size) ? *next : res->size;
+
+            SpriteFrame frame;
+            frame.offset = res->offset + start;
+            frame.rleSize = end - start;
+            measureFrame(table + start, frame.rleSize, frame.width, frame.height);
+            if (frame.width == 0 || frame.height == 0) {
+                continue;
+            }
+            frame.animationId = id;
+            frame.frameIndex = i;
+            frames_.push_back(frame);
+            animation.frameCount++;
+        }
+
+        if (animation.frameCount > 0) {
+            animations_.push_back(animation);
+        }
+    }
+
+    if (frames_.empty()) {
+        lastError_ = "No sprite tables in " + datPath;
+        return false;
+    }
+    return true;
+}
+
+bool SpriteIndex::load(const std::string& path, const std::string& datPath) {
+    clear();
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        lastError_ = "Failed to open sprite index: " + path;
+        return false;
+    }
+
+    auto fileSize = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+
+    std::vector<uint8_t> blob(fileSize);
+    file.read(reinterpret_cast<char*>(blob.data()), fileSize);
+    if (!file || fileSize < sizeof(SpriteIndexFileHeader)) {
+        lastError_ = "Failed to read sprite index: " + path;
+        return false;
+    }
+
+    SpriteIndexFileHeader header;
+    std::memcpy(&header, blob.data(), sizeof(header));
+    if (std::memcmp(header.magic, SPRITE_INDEX_MAGIC, 4) != 0 || header.version != SPRITE_INDEX_VERSION) {
+        lastError_ = "Unsupported sprite index format: " + path;
+        return false;
+    }
+
+    size_t animationBytes = static_cast<size_t>(header.animationCount) * sizeof(SpriteAnimation);
+    size_t frameBytes = static_cast<size_t>(header.frameCount) * sizeof(SpriteFrame);
+    if (sizeof(SpriteIndexFileHeader) + animationBytes + frameBytes != fileSize) {
+        lastError_ = "Sprite index is truncated: " + path;
+        return false;
+    }
+
+    // Built from another version of the DAT file
+    std::error_code ec;
+    uint64_t sourceSize = static_cast<uint64_t>(fs::file_size(datPath, ec));
+    if (ec || sourceSize != header.sourceSize || getModifiedTime(datPath) != header.sourceModifiedTime) {
+        lastError_ = "Sprite index is stale: " + path;
+        return false;
+    }
+
+    if (!mapSource(datPath)) {
+        return false;
+    }
+
+    const uint8_t* ptr = blob.data() + sizeof(SpriteIndexFileHeader);
+    animations_.resize(header.animationCount);
+    std::memcpy(animations_.data(), ptr, animationBytes);
+    ptr += animationBytes;
+
+    frames_.resize(header.frameCount);
+    std::memcpy(frames_.data(), ptr, frameBytes);
+
+    // Every range has to stay inside the frame table and the DAT file
+    for (const auto& animation : animations_) {
+        if (animation.firstFrame > frames_.size() ||
+            animation.frameCount > frames_.size() - animation.firstFrame) {
+            clear();
+            lastError_ = "Sprite index is corrupt: " + path;
+            return false;
+        }
+    }
+    for (const auto& frame : frames_) {
+        if (!mapping_->at(frame.offset, frame.rleSize)) {
+            clear();
+            lastError_ = "Sprite index is corrupt: " + path;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool SpriteIndex::save(const std::string& path) const {
+    SpriteIndexFileHeader header;
+    std::memcpy(header.magic, SPRITE_INDEX_MAGIC, 4);
+    header.version = SPRITE_INDEX_VERSION;
+    header.sourceSize = sourceSize_;
+    header.sourceModifiedTime = sourceModifiedTime_;
+    header.animationCount = static_cast<uint32_t>(animations_.size());
+    header.frameCount = static_cast<uint32_t>(frames_.size());
+
+    // Write to a temp file and rename, so a crash never leaves a torn index
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(animations_.data()),
+                   animations_.size() * sizeof(SpriteAnimation));
+        file.write(reinterpret_cast<const char*>(frames_.data()), frames_.size() * sizeof(SpriteFrame));
+        if (!file) {
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tempPath, path, ec);
+    return !ec;
+}
+
+const SpriteFrame* SpriteIndex::getFrame(uint32_t spriteId) const {
+    return spriteId < frames_.size() ? &frames_[spriteId] : nullptr;
+}
+
+const SpriteAnimation* SpriteIndex::findAnimation(uint16_t animationId) const {
+    auto it = std::lower_bound(animations_.begin(), animations_.end(), animationId,
+                               [](const SpriteAnimation& animation, uint16_t id) {
+                                   return animation.id < id;
+                               });
+    return (it != animations_.end() && it->id == animationId) ? &*it : nullptr;
+}
+
+const SpriteFrame* SpriteIndex::findFrame(uint16_t animationId, uint16_t frameIndex) const {
+    const SpriteAnimation* animation = findAnimation(animationId);
+    if (!animation) {
+        return nullptr;
+    }
+
+    // Frames that failed to parse leave gaps, so search rather than index
+    auto first = frames_.begin() + animation->firstFrame;
+    auto last = first + animation->frameCount;
+    auto it = std::lower_bound(first, last, frameIndex, [](const SpriteFrame& frame, uint16_t index) {
+        return frame.frameIndex < index;
+    });
+    return (it != last && it->frameIndex == frameIndex) ? &*it : nullptr;
+}
+
+bool SpriteIndex::decodeFrame(const SpriteFrame& frame, std::vector<uint8_t>& pixels) const {
+    const uint8_t* src = mapping_ ? mapping_->at(frame.offset, frame.rleSize) : nullptr;
+    if (!src) {
+        return false;
+    }
+
+    pixels.assign(static_cast<size_t>(frame.width) * frame.height, 0);
+    decodeRLERows(src, frame.rleSize, pixels.data(), frame.width, frame.height);
+    return true;
+}
+
+bool SpriteIndex::compileFrame(const SpriteFrame& frame, SpanSprite& sprite) const {
+    const uint8_t* src = mapping_ ? mapping_->at(frame.offset, frame.rleSize) : nullptr;
+    if (!src) {
+        return false;
+    }
+    return compileSpansRows(src, frame.rleSize, frame.width, frame.height, sprite);
+}
+
+} // namespace opengg
@@ -0,0 +1,227 @@
+#include "texture_atlas.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+// SDL2 is optional for this module
+#ifdef SDL_h_
+#include <SDL.h>
+#endif
+
+namespace opengg {
+
+// Empty pixels kept between sprites so filtering never samples a neighbour
+static constexpr int ATLAS_PADDING = 1;
+
+// === SkylinePacker ===
+
+SkylinePacker::SkylinePacker(int width, int height)
+    : width_(width), height_(height) {
+    reset();
+}
+
+void SkylinePacker::reset() {
+    skyline_.clear();
+    skyline_.push_back({0, 0, width_});
+    usedArea_ = 0;
+}
+
+int SkylinePacker::fitAt(size_t index, int width, int height) const {
+    int x = skyline_[index].x;
+    if (x + width > width_) {
+        return -1;
+    }
+
+    // Rest on the highest segment under the rectangle
+    int y = 0;
+    int remaining = width;
+    for (size_t i = index; remaining > 0; ++i) {
+        y = std::max(y, skyline_[i].y);
+        if (y + height > height_) {
+            return -1;
+        }
+        remaining -= skyline_[i].width;
+    }
+    return y;
+}
+
+bool SkylinePacker::pack(int width, int height, int& outX, int& outY) {
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+
+    // Lowest top edge wins; ties go to the narrowest segment
+    size_t bestIndex = SIZE_MAX;
+    int bestTop = INT_MAX;
+    int bestWidth = INT_MAX;
+    for (size_t i = 0; i < skyline_.size(); ++i) {
+        int y = fitAt(i, width, height);
+        if (y < 0) {
+            continue;
+        }
+        int top = y + height;
+        if (top < bestTop || (top == bestTop && skyline_[i].width < bestWidth)) {
+            bestIndex = i;
+            bestTop = top;
+            bestWidth = skyline_[i].width;
+            outX = skyline_[i].x;
+            outY = y;
+        }
+    }
+
+    if (bestIndex == SIZE_MAX) {
+        return false;
+    }
+
+    // Raise the skyline over the new rectangle, trimming the segments it covers
+    skyline_.insert(skyline_.begin() + bestIndex, {outX, bestTop, width});
+    size_t i = bestIndex + 1;
+    while (i < skyline_.size()) {
+        Segment& seg = skyline_[i];
+        int covered = outX + width - seg.x;
+        if (covered <= 0) {
+            break;
+        }
+        if (covered < seg.width) {
+            seg.x += covered;
+            seg.width -= covered;
+            break;
+        }
+        skyline_.erase(skyline_.begin() + i);
+    }
+
+    // Merge neighbours at the same height
+    for (size_t j = 0; j + 1 < skyline_.size();) {
+        if (skyline_[j].y == skyline_[j + 1].y) {
+            skyline_[j].width += skyline_[j + 1].width;
+            skyline_.erase(skyline_.begin() + j + 1);
+        } else {
+            ++j;
+        }
+    }
+
+    usedArea_ += static_cast<size_t>(width) * height;
+    return true;
+}
+
+// === TextureAtlas ===
+
+TextureAtlas::TextureAtlas(SDL_Renderer* renderer, int pageSize)
+    : renderer_(renderer), pageSize_(pageSize) {
+}
+
+TextureAtlas::~TextureAtlas() {
+#ifdef SDL_h_
+    for (auto& page : pages_) {
+        if (page.texture) {
+            SDL_DestroyTexture(page.texture);
+        }
+    }
+#endif
+}
+
+bool TextureAtlas::addPage(int width, int height) {
+#ifdef SDL_h_
+    SDL_Texture* texture = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_ARGB8888,
+                                             SDL_TEXTUREACCESS_STATIC, width, height);
+    if (!texture) {
+        lastError_ = "Failed to create atlas page: " + std::string(SDL_GetError());
+        return false;
+    }
+
+    // Static textures start undefined; clear the page so the padding
+    // between sprites is transparent
+    std::vector<uint32_t> clear(static_cast<size_t>(width) * height, 0);
+    if (SDL_UpdateTexture(texture, nullptr, clear.data(), width * static_cast<int>(sizeof(uint32_t))) != 0) {
+        lastError_ = "Failed to clear atlas page: " + std::string(SDL_GetError());
+        SDL_DestroyTexture(texture);
+        return false;
+    }
+
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    pages_.push_back({texture, SkylinePacker(width, height)});
+    return true;
+#else
+    (void)width;
+    (void)height;
+    lastError_ = "SDL2 not available";
+    return false;
+#endif
+}
+
+bool TextureAtlas::add(const std::string& key, SDL_Surface* surface) {
+#ifdef SDL_h_
+    if (regions_.count(key)) {
+        return true;
+    }
+    if (!surface || !renderer_) {
+        lastError_ = "No surface or renderer";
+        return false;
+    }
+
+    int paddedW = surface->w + ATLAS_PADDING;
+    int paddedH = surface->h + ATLAS_PADDING;
+
+    // Newest page first; earlier pages are mostly full
+    size_t pageIndex = pages_.size();
+    int x = 0, y = 0;
+    for (size_t i = pages_.size(); i-- > 0;) {
+        if (pages_[i].packer.pack(paddedW, paddedH, x, y)) {
+            pageIndex = i;
+            break;
+        }
+    }
+    if (pageIndex == pages_.size()) {
+        if (!addPage(std::max(pageSize_, paddedW), std::max(pageSize_, paddedH)) ||
+            !pages_.back().packer.pack(paddedW, paddedH, x, y)) {
+            return false;
+        }
+    }
+
+    // Pages are ARGB8888; colour keys become transparent in the conversion
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    if (!converted) {
+        lastError_ = "Failed to convert sprite: " + std::string(SDL_GetError());
+        return false;
+    }
+
+    SDL_Rect rect = {x, y, surface->w, surface->h};
+    int result = SDL_UpdateTexture(pages_[pageIndex].texture, &rect,
+                                   converted->pixels, converted->pitch);
+    SDL_FreeSurface(converted);
+    if (result != 0) {
+        lastError_ = "Failed to upload sprite: " + std::string(SDL_GetError());
+        return false;
+    }
+
+    AtlasRegion region;
+    region.texture = pages_[pageIndex].texture;
+    region.x = x;
+    region.y = y;
+    region.width = surface->w;
+    region.height = surface->h;
+    regions_[key] = region;
+    return true;
+#else
+    (void)key;
+    (void)surface;
+    lastError_ = "SDL2 not available";
+    return false;
+#endif
+}
+
+const AtlasRegion* TextureAtlas::find(const std::string& key) const {
+    auto it = regions_.find(key);
+    return it != regions_.end() ? &it->second : nullptr;
+}
+
+size_t TextureAtlas::getMemoryBytes() const {
+    size_t bytes = 0;
+    for (const auto& page : pages_) {
+        bytes += static_cast<size_t>(page.packer.getWidth()) * page.packer.getHeight() * 4;
+    }
+    return bytes;
+}
+
+} // namespace opengg
@@ -708,9 +708,17 @@ public:
 
     void clearPreview() {
         if (previewTexture_) {
-            SDL_DestroyTexture(previewTexture_);
+            if (!previewSprite_.empty()) {
+                // Extracted sprites belong to the asset cache
+                if (AssetCache* cache = game_->getAssetCache()) {
+                    cache->releaseExtractedTexture(gameId_, previewSprite_);
+                }
+            } else {
+                SDL_DestroyTexture(previewTexture_);
+            }
             previewTexture_ = nullptr;
         }
+        previewSprite_.clear();
         previewWidth_ = 0;
         previewHeight_ = 0;
     }
@@ -734,6 +742,7 @@ public:
                 int w, h;
                 previewTexture_ = cache->loadExtractedTexture(gameId_, filename, &w, &h);
                 if (previewTexture_) {
+                    previewSprite_ = filename;
                     previewWidth_ = w;
                     previewHeight_ = h;
                 }
@@ -1135,6 +1144,7 @@ private:
     static const int maxVisibleItems_ = 14;
 
     SDL_Texture* previewTexture_ = nullptr;
+    std::string previewSprite_;     // Set when the preview is a cached extracted sprite
     int previewWidth_ = 0;
     int previewHeight_ = 0;
     bool needsPreviewUpdate_ = false;
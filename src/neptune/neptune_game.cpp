@@ -46,9 +46,14 @@ void NeptuneGameState::enter() {
 
 void NeptuneGameState::exit() {
     SDL_Log("Neptune: Exiting game state");
+
+    // Let the cache evict this state's textures once over budget
+    releaseAssets();
 }
 
 void NeptuneGameState::update(float dt) {
+    resolveAssets();
+
     switch (currentSection_) {
         case NeptuneSection::Submarine:
             updateSubmarine(dt);
@@ -198,22 +203,16 @@ void NeptuneGameState::loadAssets() {
         auto sprites = cache->listExtractedAssets("on", "sprites");
         SDL_Log("Neptune: Found %zu extracted sprites", sprites.size());
 
-        // Try loading the submarine sprite (common sprite names)
-        submarineTexture_ = cache->loadExtractedTexture("on", "submarine",
-                                                         &submarineTexW_, &submarineTexH_);
-        if (!submarineTexture_) {
-            // Try alternate names
-            submarineTexture_ = cache->loadExtractedTexture("on", "sub",
-                                                             &submarineTexW_, &submarineTexH_);
-        }
-
-        // Try loading background
-        backgroundTexture_ = cache->loadExtractedTexture("on", "background",
-                                                          nullptr, nullptr);
-        if (!backgroundTexture_) {
-            backgroundTexture_ = cache->loadExtractedTexture("on", "ocean_bg",
-                                                              nullptr, nullptr);
-        }
+        // Stream the submarine and background in (common sprite names,
+        // preferred first); resolveAssets() picks them up as they land
+        submarineRequests_ = {
+            cache->requestExtractedTexture("on", "submarine"),
+            cache->requestExtractedTexture("on", "sub")
+        };
+        backgroundRequests_ = {
+            cache->requestExtractedTexture("on", "background"),
+            cache->requestExtractedTexture("on", "ocean_bg")
+        };
 
         // Load sounds
         auto wavFiles = cache->listExtractedAssets("on", "wav");
@@ -225,6 +224,76 @@ void NeptuneGameState::loadAssets() {
     }
 }
 
+// Keep the most preferred request that loaded, once every request ahead of
+// it has finished; the other requests' references are given back, including
+// those of requests still in flight
+static std::shared_ptr<TextureRequest> resolveTexture(AssetCache* cache,
+                                                      std::vector<std::shared_ptr<TextureRequest>>& requests) {
+    for (const auto& request : requests) {
+        if (!request->isDone()) {
+            return nullptr;
+        }
+        if (request->state == TextureRequest::State::Ready) {
+            break;
+        }
+    }
+
+    std::shared_ptr<TextureRequest> kept;
+    for (const auto& request : requests) {
+        if (!kept && request->state == TextureRequest::State::Ready) {
+            kept = request;
+        } else {
+            cache->releaseRequest(request);
+        }
+    }
+
+    requests.clear();
+    return kept;
+}
+
+void NeptuneGameState::resolveAssets() {
+    AssetCache* cache = game_->getAssetCache();
+    if (!cache) {
+        return;
+    }
+
+    if (!submarineRequests_.empty()) {
+        submarineRequest_ = resolveTexture(cache, submarineRequests_);
+        if (submarineRequest_) {
+            submarineTexture_ = submarineRequest_->texture;
+            submarineTexW_ = submarineRequest_->width;
+            submarineTexH_ = submarineRequest_->height;
+        }
+    }
+    if (!backgroundRequests_.empty()) {
+        backgroundRequest_ = resolveTexture(cache, backgroundRequests_);
+        if (backgroundRequest_) {
+            backgroundTexture_ = backgroundRequest_->texture;
+        }
+    }
+}
+
+void NeptuneGameState::releaseAssets() {
+    AssetCache* cache = game_->getAssetCache();
+    if (cache) {
+        for (const auto& request : submarineRequests_) {
+            cache->releaseRequest(request);
+        }
+        for (const auto& request : backgroundRequests_) {
+            cache->releaseRequest(request);
+        }
+        cache->releaseRequest(submarineRequest_);
+        cache->releaseRequest(backgroundRequest_);
+    }
+
+    submarineRequests_.clear();
+    backgroundRequests_.clear();
+    submarineRequest_.reset();
+    backgroundRequest_.reset();
+    submarineTexture_ = nullptr;
+    backgroundTexture_ = nullptr;
+}
+
 void NeptuneGameState::loadRooms() {
     // Create test room structure
     NeptuneRoom room1;
@@ -1,13 +1,23 @@
 #include "ne_resource.h"
 #include "grp_archive.h"
+#include "mapped_file.h"
+#include "decompress.h"
+#include "sprite_index.h"
+#include "span_sprite.h"
+#include "smacker.h"
+#include "palette.h"
+#include "crc32.h"
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <filesystem>
 #include <string>
 #include <vector>
 #include <cstring>
 #include <map>
 #include <algorithm>
+#include <chrono>
+#include <functional>
 
 namespace fs = std::filesystem;
 using namespace opengg;
@@ -103,6 +113,7 @@ void printUsage(const char* progName) {
     std::cout << "                           Extract single sprite at offset using header dims\n";
     std::cout << "  extract-indexed <file> <palette> <outdir>\n";
     std::cout << "                           Extract all sprites using index metadata\n";
+    std::cout << "  index-sprites <file>     Build the sprite frame index from the ASEQ/LT tables\n";
     std::cout << "  extract-rund <file> <palette> <outdir>\n";
     std::cout << "                           Extract RUND format sprites (Treasure games)\n";
     std::cout << "  extract-labyrinth <file> <outdir>\n";
@@ -113,6 +124,12 @@ void printUsage(const char* progName) {
     std::cout << "                           Extract sprite with specified dimensions\n";
     std::cout << "  test-rle <file> <palette> <offset> <w> <h> <outdir>\n";
     std::cout << "                           Test different RLE formats\n";
+    std::cout << "  bench-rle <file>         Benchmark RLE decoders on GRP/DAT sprite data\n";
+    std::cout << "  bench-lz <file|dir>      Benchmark and verify the LZ decoder on GRP archives\n";
+    std::cout << "  bench-smk <file|dir> [check|write <crcs>]\n";
+    std::cout << "                           Decode every Smacker video headless and time each stage;\n";
+    std::cout << "                           check compares per-frame CRCs with crcs, write saves\n";
+    std::cout << "                           them there (only if every video decoded)\n";
     std::cout << "\n";
 }
 
@@ -5483,6 +5500,629 @@ void extractSingleSprite(const std::string& datPath, const std::string& paletteP
     std::cout << "Wrote: " << outPath << "\n";
 }
 
+// ---------------------------------------------------------------------------
+// RLE/LZ decoder benchmarks
+// The reference decoders are the per-byte loops the loader used before
+// the shared kernels in decompress.h; they stay here so the kernels
+// can be checked byte for byte against them on real game data.
+// ---------------------------------------------------------------------------
+
+static std::vector<uint8_t> referenceRLEPackBits(const uint8_t* src, size_t srcSize, size_t outSize) {
+    std::vector<uint8_t> output;
+    output.reserve(outSize);
+
+    size_t i = 0;
+    while (i < srcSize && output.size() < outSize) {
+        uint8_t control = src[i++];
+        if (control & 0x80) {
+            uint8_t count = (control & 0x7F) + 1;
+            if (i >= srcSize) break;
+            uint8_t value = src[i++];
+            for (uint8_t j = 0; j < count && output.size() < outSize; ++j) {
+                output.push_back(value);
+            }
+        } else {
+            uint8_t count = control + 1;
+            for (uint8_t j = 0; j < count && i < srcSize && output.size() < outSize; ++j) {
+                output.push_back(src[i++]);
+            }
+        }
+    }
+    return output;
+}
+
+// Per-byte version of decodeRLERows (DAT frames read through SpriteIndex)
+static std::vector<uint8_t> referenceRLERows(const uint8_t* data, size_t dataSize,
+                                             size_t width, size_t height) {
+    std::vector<uint8_t> pixels(width * height, 0);
+
+    size_t i = 0, x = 0, y = 0;
+    while (i < dataSize && y < height) {
+        if (data[i] == 0x00) {
+            x = 0;
+            y++;
+            i++;
+        } else if (data[i] == 0xFF && i + 2 < dataSize) {
+            uint8_t byte = data[i + 1];
+            for (int j = 0; j <= data[i + 2]; ++j, ++x) {
+                if (x < width) pixels[y * width + x] = byte;
+            }
+            i += 3;
+        } else {
+            if (x < width) pixels[y * width + x] = data[i];
+            x++;
+            i++;
+        }
+    }
+    return pixels;
+}
+
+static std::vector<uint8_t> referenceRLESprite(const uint8_t* data, size_t size, size_t pixelDataSize) {
+    std::vector<uint8_t> pixels(pixelDataSize);
+    size_t srcIdx = 0;
+    size_t dstIdx = 0;
+
+    while (srcIdx < size && dstIdx < pixelDataSize) {
+        uint8_t cmd = data[srcIdx++];
+        if (cmd == 0) {
+            if (srcIdx < size) {
+                uint8_t count = data[srcIdx++];
+                if (count == 0) break;
+                dstIdx += count;
+            }
+        } else if (cmd < 128) {
+            for (uint8_t i = 0; i < cmd && srcIdx < size && dstIdx < pixelDataSize; ++i) {
+                pixels[dstIdx++] = data[srcIdx++];
+            }
+        } else {
+            uint8_t count = cmd - 128;
+            if (srcIdx < size) {
+                uint8_t value = data[srcIdx++];
+                for (uint8_t i = 0; i < count && dstIdx < pixelDataSize; ++i) {
+                    pixels[dstIdx++] = value;
+                }
+            }
+        }
+    }
+    return pixels;
+}
+
+struct DecoderBenchInput {
+    std::string name;
+    std::vector<uint8_t> data;
+    size_t outSize;
+    size_t width = 0;           // Row decoders only
+};
+
+using ReferenceDecoder = std::function<std::vector<uint8_t>(const DecoderBenchInput&)>;
+using KernelDecoder = std::function<size_t(const DecoderBenchInput&, uint8_t*)>;
+
+// Adapters for decoders that only need the output size
+static ReferenceDecoder sizedReference(std::vector<uint8_t> (*decode)(const uint8_t*, size_t, size_t)) {
+    return [decode](const DecoderBenchInput& in) {
+        return decode(in.data.data(), in.data.size(), in.outSize);
+    };
+}
+
+static KernelDecoder sizedKernel(size_t (*decode)(const uint8_t*, size_t, uint8_t*, size_t)) {
+    return [decode](const DecoderBenchInput& in, uint8_t* dst) {
+        return decode(in.data.data(), in.data.size(), dst, in.outSize);
+    };
+}
+
+// Verify and time one decoder pair over a set of inputs
+static bool benchDecoder(const std::string& label, const std::vector<DecoderBenchInput>& inputs,
+                           const ReferenceDecoder& reference, const KernelDecoder& kernel) {
+    if (inputs.empty()) {
+        std::cout << label << ": no inputs\n\n";
+        return true;
+    }
+
+    size_t inBytes = 0;
+    size_t outBytes = 0;
+    size_t mismatches = 0;
+    for (const auto& in : inputs) {
+        inBytes += in.data.size();
+        outBytes += in.outSize;
+
+        auto expected = reference(in);
+        std::vector<uint8_t> actual(in.outSize, 0);
+        kernel(in, actual.data());
+        if (actual != expected) {
+            if (mismatches++ < 5) {
+                std::cerr << "  MISMATCH: " << in.name << "\n";
+            }
+        }
+    }
+
+    // Repeat until each side has run long enough to time reliably
+    auto timeDecoder = [&](const std::function<void()>& pass) {
+        using Clock = std::chrono::steady_clock;
+        int iterations = 0;
+        auto start = Clock::now();
+        double elapsed = 0.0;
+        do {
+            pass();
+            iterations++;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < 0.25 || iterations < 3);
+        return elapsed / iterations;
+    };
+
+    volatile size_t sink = 0;
+    double refTime = timeDecoder([&]() {
+        for (const auto& in : inputs) {
+            sink = sink + reference(in).size();
+        }
+    });
+
+    std::vector<uint8_t> buffer;
+    double kernelTime = timeDecoder([&]() {
+        for (const auto& in : inputs) {
+            // Match the loader, which decodes into a zeroed, pre-sized buffer
+            buffer.assign(in.outSize, 0);
+            sink = sink + kernel(in, buffer.data());
+        }
+    });
+
+    double outMB = outBytes / (1024.0 * 1024.0);
+    printf("%s: %zu inputs, %zu -> %zu bytes\n", label.c_str(), inputs.size(), inBytes, outBytes);
+    printf("  reference: %9.3f ms/pass  %8.1f MB/s\n", refTime * 1000.0, outMB / refTime);
+    printf("  kernel:    %9.3f ms/pass  %8.1f MB/s  (%.2fx)\n",
+           kernelTime * 1000.0, outMB / kernelTime, refTime / kernelTime);
+    printf("  output:    %s\n\n", mismatches ? "MISMATCH" : "identical");
+    return mismatches == 0;
+}
+
+// Build the runtime sprite index (the loader's SpriteIndex) and decode every
+// frame through it once
+bool indexSprites(const std::string& datPath) {
+    using Clock = std::chrono::steady_clock;
+
+    SpriteIndex index;
+    auto start = Clock::now();
+    if (!index.build(datPath)) {
+        std::cerr << "Error: " << index.getLastError() << "\n";
+        return false;
+    }
+    double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    printf("Indexed %zu frames in %zu animations (%.2f ms)\n\n",
+           index.getFrameCount(), index.getAnimationCount(), buildMs);
+    printf("  Anim   Frames  Palette  First frame\n");
+    for (const auto& animation : index.getAnimations()) {
+        const SpriteFrame* first = index.getFrame(animation.firstFrame);
+        printf("  %5u  %6u  %7s  0x%08X %ux%u, %u bytes\n",
+               animation.id, animation.frameCount, animation.paletteId ? "own" : "game",
+               first->offset, first->width, first->height, first->rleSize);
+    }
+
+    std::vector<uint8_t> pixels;
+    size_t totalPixels = 0;
+    start = Clock::now();
+    for (uint32_t id = 0; id < index.getFrameCount(); ++id) {
+        index.decodeFrame(*index.getFrame(id), pixels);
+        totalPixels += pixels.size();
+    }
+    double decodeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    printf("\nDecoded all frames in %.2f ms (%.1f Mpixel/s)\n", decodeMs,
+           decodeMs > 0 ? totalPixels / (decodeMs * 1000.0) : 0.0);
+
+    // Same frames compiled to opaque spans, then drawn into a 640x480 screen
+    std::vector<SpanSprite> compiled(index.getFrameCount());
+    size_t spanBytes = 0;
+    start = Clock::now();
+    for (uint32_t id = 0; id < index.getFrameCount(); ++id) {
+        index.compileFrame(*index.getFrame(id), compiled[id]);
+        spanBytes += compiled[id].getMemoryUsage();
+    }
+    double compileMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    printf("Compiled all frames in %.2f ms (%.1f Mpixel/s), %zu KB as spans vs %zu KB decoded\n",
+           compileMs, compileMs > 0 ? totalPixels / (compileMs * 1000.0) : 0.0,
+           spanBytes / 1024, totalPixels / 1024);
+
+    std::vector<uint32_t> screen(640 * 480);
+    uint32_t lut[256];
+    for (uint32_t i = 0; i < 256; ++i) {
+        lut[i] = 0xFF000000 | (i * 0x010101);
+    }
+    start = Clock::now();
+    for (const auto& sprite : compiled) {
+        blitSpans32(sprite, screen.data(), 640 * 4, 640, 480, 0, 0, lut);
+    }
+    double blitMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    printf("Blitted all frames (32-bit) in %.2f ms\n", blitMs);
+    return true;
+}
+
+bool benchRLE(const std::string& path) {
+    std::vector<DecoderBenchInput> packBits;
+    std::vector<DecoderBenchInput> sprites;
+
+    std::string ext = fs::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+    if (ext == ".grp") {
+        GrpArchive grp;
+        MappedFile file;
+        if (!grp.open(path) || !file.open(path)) {
+            std::cerr << "Error: failed to open " << path << "\n";
+            return false;
+        }
+
+        for (const auto& name : grp.listFiles()) {
+            const GrpEntry* entry = grp.getEntry(name);
+
+            // Compressed entries: the stored RLE stream (entries with a zero
+            // compressed size are stored uncompressed and have none)
+            if ((entry->flags & GRP_COMPRESSION_RLE) && entry->compressedSize != 0) {
+                const uint8_t* stored = file.at(entry->offset, entry->compressedSize);
+                if (stored) {
+                    packBits.push_back({name, std::vector<uint8_t>(stored, stored + entry->compressedSize),
+                                        entry->size});
+                }
+            }
+
+            // Sprites whose pixel data is too short to be raw are RLE encoded
+            auto data = grp.extract(name);
+            if (data.size() < sizeof(SpriteHeader)) continue;
+            const SpriteHeader* header = reinterpret_cast<const SpriteHeader*>(data.data());
+            if (header->width == 0 || header->height == 0 ||
+                header->width > 4096 || header->height > 4096) continue;
+            size_t pixels = static_cast<size_t>(header->width) * header->height;
+            if (sizeof(SpriteHeader) + pixels <= data.size()) continue;
+            sprites.push_back({name, std::vector<uint8_t>(data.begin() + sizeof(SpriteHeader), data.end()),
+                               pixels});
+        }
+    } else {
+        // Only the frames of the CUSTOM_32513 sprite tables, as the loader
+        // finds them; bitmaps, sounds and other resources are not sprite RLE
+        SpriteIndex index;
+        MappedFile file;
+        if (!index.build(path) || !file.open(path)) {
+            std::cerr << "Error: failed to index sprites in " << path << "\n";
+            return false;
+        }
+
+        for (uint32_t id = 0; id < index.getFrameCount(); ++id) {
+            const SpriteFrame* frame = index.getFrame(id);
+            const uint8_t* stored = file.at(frame->offset, frame->rleSize);
+            if (!stored || frame->width == 0 || frame->height == 0) continue;
+            DecoderBenchInput input;
+            input.name = std::to_string(frame->animationId) + ":" + std::to_string(frame->frameIndex);
+            input.data.assign(stored, stored + frame->rleSize);
+            input.outSize = static_cast<size_t>(frame->width) * frame->height;
+            input.width = frame->width;
+            sprites.push_back(std::move(input));
+        }
+    }
+
+    std::cout << "RLE benchmark: " << path << "\n\n";
+
+    bool ok = true;
+    if (ext == ".grp") {
+        // A truncated stream leaves the rest of the loader's zeroed buffer
+        // untouched, so pad the reference the same way
+        auto reference = [](const uint8_t* src, size_t srcSize, size_t outSize) {
+            auto output = referenceRLEPackBits(src, srcSize, outSize);
+            output.resize(outSize, 0);
+            return output;
+        };
+        ok &= benchDecoder("GRP entry RLE", packBits, sizedReference(reference),
+                           sizedKernel(decodeRLEPackBits));
+        ok &= benchDecoder("GRP sprite RLE", sprites, sizedReference(referenceRLESprite),
+                           sizedKernel(decodeRLESprite));
+    } else {
+        auto reference = [](const DecoderBenchInput& in) {
+            return referenceRLERows(in.data.data(), in.data.size(), in.width, in.outSize / in.width);
+        };
+        auto kernel = [](const DecoderBenchInput& in, uint8_t* dst) {
+            return decodeRLERows(in.data.data(), in.data.size(), dst, in.width, in.outSize / in.width);
+        };
+        ok &= benchDecoder("DAT sprite RLE", sprites, reference, kernel);
+    }
+    return ok;
+}
+
+// Byte-at-a-time LZ decoder the loader used before decodeLZ
+static std::vector<uint8_t> referenceLZ(const uint8_t* src, size_t srcSize, size_t outSize) {
+    std::vector<uint8_t> output;
+    output.reserve(outSize);
+
+    size_t i = 0;
+    while (i < srcSize && output.size() < outSize) {
+        uint8_t flags = src[i++];
+        for (int bit = 0; bit < 8 && i < srcSize && output.size() < outSize; ++bit) {
+            if (flags & (1 << bit)) {
+                output.push_back(src[i++]);
+            } else {
+                if (i + 1 >= srcSize) break;
+                uint16_t ref = src[i] | (src[i + 1] << 8);
+                i += 2;
+
+                uint16_t offset = (ref >> 4) + 1;
+                uint16_t length = (ref & 0x0F) + 3;
+                for (uint16_t j = 0; j < length && output.size() < outSize; ++j) {
+                    size_t srcIdx = output.size() - offset;
+                    output.push_back(srcIdx < output.size() ? output[srcIdx] : 0);
+                }
+            }
+        }
+    }
+    return output;
+}
+
+bool benchLZ(const std::string& path) {
+    // A single archive, or every GRP under a game directory
+    std::vector<std::string> archives;
+    if (fs::is_directory(path)) {
+        for (const auto& entry : fs::recursive_directory_iterator(path)) {
+            std::string ext = entry.path().extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+            if (entry.is_regular_file() && ext == ".grp") {
+                archives.push_back(entry.path().string());
+            }
+        }
+        std::sort(archives.begin(), archives.end());
+    } else {
+        archives.push_back(path);
+    }
+
+    std::vector<DecoderBenchInput> inputs;
+    for (const auto& archivePath : archives) {
+        GrpArchive grp;
+        MappedFile file;
+        if (!grp.open(archivePath) || !file.open(archivePath)) {
+            std::cerr << "Skipping " << archivePath << ": failed to open\n";
+            continue;
+        }
+
+        for (const auto& name : grp.listFiles()) {
+            const GrpEntry* entry = grp.getEntry(name);
+            if (!(entry->flags & GRP_COMPRESSION_LZ) || (entry->flags & GRP_COMPRESSION_RLE)) continue;
+            const uint8_t* stored = file.at(entry->offset, entry->compressedSize);
+            if (stored) {
+                inputs.push_back({archivePath + ":" + name,
+                                  std::vector<uint8_t>(stored, stored + entry->compressedSize),
+                                  entry->size});
+            }
+        }
+    }
+
+    std::cout << "LZ benchmark: " << archives.size() << " archive(s)\n\n";
+
+    // decodeLZ may write past its result, so compare only the decoded prefix
+    auto kernel = [](const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+        size_t written = decodeLZ(src, srcSize, dst, dstSize);
+        std::memset(dst + written, 0, dstSize - written);
+        return written;
+    };
+    auto reference = [](const uint8_t* src, size_t srcSize, size_t outSize) {
+        auto output = referenceLZ(src, srcSize, outSize);
+        output.resize(outSize, 0);
+        return output;
+    };
+    return benchDecoder("GRP entry LZ", inputs, sizedReference(reference), sizedKernel(kernel));
+}
+
+// Per-frame checksums of one video: the displayed ARGB frame and the
+// decoded audio of all tracks
+struct SmackerFrameCRC {
+    uint32_t video;
+    uint32_t audio;
+};
+
+// What bench-smk does with its per-frame CRCs
+enum class BaselineMode {
+    None,
+    Check,
+    Write
+};
+
+bool benchSmacker(const std::string& path, BaselineMode mode, const std::string& baselinePath) {
+    using Clock = std::chrono::steady_clock;
+
+    // A single video, or every SMK under a game directory
+    std::vector<std::string> videos;
+    if (fs::is_directory(path)) {
+        for (const auto& entry : fs::recursive_directory_iterator(path)) {
+            std::string ext = entry.path().extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+            if (entry.is_regular_file() && ext == ".smk") {
+                videos.push_back(entry.path().string());
+            }
+        }
+        std::sort(videos.begin(), videos.end());
+    } else {
+        videos.push_back(path);
+    }
+
+    // Baseline lines: <frame> <video crc> <audio crc> <video>, video paths
+    // relative to the benchmarked directory. The path comes last so it may
+    // contain spaces.
+    std::map<std::string, std::vector<SmackerFrameCRC>> baseline;
+    bool checking = mode == BaselineMode::Check;
+    if (checking) {
+        std::ifstream in(baselinePath);
+        if (!in) {
+            std::cerr << "Error: cannot read baseline " << baselinePath << "\n";
+            return false;
+        }
+        std::string line;
+        size_t lineNumber = 0;
+        while (std::getline(in, line)) {
+            lineNumber++;
+            if (line.empty()) {
+                continue;
+            }
+
+            std::istringstream fields(line);
+            uint32_t frame;
+            SmackerFrameCRC crc;
+            std::string name;
+            fields >> frame >> std::hex >> crc.video >> crc.audio;
+            if (fields.get() != ' ' || !std::getline(fields, name) || name.empty()) {
+                std::cerr << "Error: " << baselinePath << ":" << lineNumber
+                          << ": malformed baseline line\n";
+                return false;
+            }
+
+            auto& frames = baseline[name];
+            if (frames.size() <= frame) {
+                frames.resize(frame + 1, {0, 0});
+            }
+            frames[frame] = crc;
+        }
+    }
+
+    std::cout << "Smacker benchmark: " << videos.size() << " video(s)\n\n";
+    printf("  %-28s %9s %6s %9s %8s   %s\n", "Video", "Size", "Frames", "Frames/s", "MB/s",
+           "ms: trees / read / palette / audio / video / convert");
+
+    SmackerDecodeStats total;
+    double totalConvertMs = 0.0;
+    double totalMs = 0.0;
+    uint64_t totalPixels = 0;
+    size_t failures = 0;
+    size_t mismatches = 0;
+    std::map<std::string, std::vector<SmackerFrameCRC>> results;
+
+    for (const auto& videoPath : videos) {
+        std::string name = fs::is_directory(path)
+            ? fs::relative(videoPath, path).generic_string() : fs::path(videoPath).filename().string();
+
+        SmackerPlayer player;
+        SmackerDecodeStats stats;
+        player.setDecodeStats(&stats);
+
+        auto start = Clock::now();
+        if (!player.open(videoPath)) {
+            std::cerr << "  " << name << ": " << player.getLastError() << "\n";
+            failures++;
+            // Attempted, so the baseline pass doesn't count it again
+            results[name];
+            continue;
+        }
+
+        // Convert as getFrameTexture() would, into a plain buffer
+        std::vector<uint32_t> argb(static_cast<size_t>(player.getWidth()) * player.getHeight());
+        std::vector<SmackerFrameCRC>& crcs = results[name];
+        double convertMs = 0.0;
+        double crcMs = 0.0;
+        while (player.nextFrame()) {
+            auto convertStart = Clock::now();
+            expandPalette8(player.getFrameIndexed().data(), argb.data(), argb.size(),
+                           player.getPaletteARGB());
+            auto crcStart = Clock::now();
+            convertMs += std::chrono::duration<double, std::milli>(crcStart - convertStart).count();
+
+            SmackerFrameCRC crc = {crc32(reinterpret_cast<const uint8_t*>(argb.data()), argb.size() * 4), 0};
+            for (int track = 0; track < 7; ++track) {
+                SmackerAudioView audio = player.getAudioSamples(track);
+                crc.audio = crc32(reinterpret_cast<const uint8_t*>(audio.samples),
+                                  audio.count * sizeof(int16_t), crc.audio);
+            }
+            crcs.push_back(crc);
+            crcMs += std::chrono::duration<double, std::milli>(Clock::now() - crcStart).count();
+        }
+        double elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() - crcMs;
+
+        // Each video counts as one failure at most
+        bool failed = false;
+        if (crcs.size() != player.getFrameCount()) {
+            std::cerr << "  " << name << ": stopped at frame " << crcs.size() << ": "
+                      << player.getLastError() << "\n";
+            failed = true;
+        }
+
+        double seconds = elapsedMs / 1000.0;
+        printf("  %-28s %4dx%-4d %6zu %9.1f %8.1f   %.2f / %.2f / %.2f / %.2f / %.2f / %.2f\n",
+               name.c_str(), player.getWidth(), player.getHeight(), crcs.size(),
+               seconds > 0 ? crcs.size() / seconds : 0.0,
+               seconds > 0 ? stats.bytesRead / (1024.0 * 1024.0) / seconds : 0.0,
+               stats.treesMs, stats.readMs, stats.paletteMs, stats.audioMs, stats.videoMs, convertMs);
+
+        total.treesMs += stats.treesMs;
+        total.readMs += stats.readMs;
+        total.paletteMs += stats.paletteMs;
+        total.audioMs += stats.audioMs;
+        total.videoMs += stats.videoMs;
+        total.bytesRead += stats.bytesRead;
+        total.frames += static_cast<uint32_t>(crcs.size());
+        totalConvertMs += convertMs;
+        totalMs += elapsedMs;
+        totalPixels += static_cast<uint64_t>(argb.size()) * crcs.size();
+
+        if (checking) {
+            auto expected = baseline.find(name);
+            if (expected == baseline.end()) {
+                printf("    not in baseline\n");
+                failed = true;
+            } else {
+                size_t frameCount = std::max(expected->second.size(), crcs.size());
+                for (size_t frame = 0; frame < frameCount; ++frame) {
+                    bool same = frame < crcs.size() && frame < expected->second.size() &&
+                                crcs[frame].video == expected->second[frame].video &&
+                                crcs[frame].audio == expected->second[frame].audio;
+                    if (!same && mismatches++ < 10) {
+                        printf("    MISMATCH at frame %zu\n", frame);
+                    }
+                }
+            }
+        }
+
+        if (failed) {
+            failures++;
+        }
+    }
+
+    double seconds = totalMs / 1000.0;
+    printf("\nTotal: %u frames in %.1f ms: %.1f frames/s, %.1f MB/s read, %.1f Mpixel/s\n",
+           total.frames, totalMs, seconds > 0 ? total.frames / seconds : 0.0,
+           seconds > 0 ? total.bytesRead / (1024.0 * 1024.0) / seconds : 0.0,
+           totalMs > 0 ? totalPixels / (totalMs * 1000.0) : 0.0);
+    printf("  trees %.1f ms, read %.1f ms, palette %.1f ms, audio %.1f ms, video %.1f ms, convert %.1f ms\n",
+           total.treesMs, total.readMs, total.paletteMs, total.audioMs, total.videoMs, totalConvertMs);
+
+    if (checking) {
+        // Videos the baseline expects that weren't found (ones that failed to
+        // open were already counted)
+        for (const auto& expected : baseline) {
+            if (!results.count(expected.first)) {
+                printf("  %s: in baseline but not decoded\n", expected.first.c_str());
+                failures++;
+            }
+        }
+        std::string summary = "identical";
+        if (failures || mismatches) {
+            summary = std::to_string(failures) + " video(s) failed, " +
+                      std::to_string(mismatches) + " frame(s) differ";
+        }
+        printf("Baseline %s: %s\n", baselinePath.c_str(), summary.c_str());
+    } else if (mode == BaselineMode::Write) {
+        // A broken run must not become the reference
+        if (failures) {
+            printf("Not writing %s: %zu video(s) failed\n", baselinePath.c_str(), failures);
+            return false;
+        }
+        std::ofstream out(baselinePath);
+        if (!out) {
+            std::cerr << "Error: cannot write baseline " << baselinePath << "\n";
+            return false;
+        }
+        char line[32];
+        for (const auto& video : results) {
+            for (size_t frame = 0; frame < video.second.size(); ++frame) {
+                snprintf(line, sizeof(line), "%08X %08X", video.second[frame].video, video.second[frame].audio);
+                out << frame << " " << line << " " << video.first << "\n";
+            }
+        }
+        printf("Wrote per-frame CRCs to %s\n", baselinePath.c_str());
+    }
+
+    return failures == 0 && mismatches == 0;
+}
+
 int main(int argc, char* argv[]) {
     if (argc < 2) {
         printUsage(argv[0]);
@@ -5545,6 +6185,8 @@ int main(int argc, char* argv[]) {
         extractSingleSprite(argv[2], argv[3], offset, argv[5]);
     } else if (command == "extract-indexed" && argc >= 5) {
         extractIndexedSprites(argv[2], argv[3], argv[4]);
+    } else if (command == "index-sprites" && argc >= 3) {
+        return indexSprites(argv[2]) ? 0 : 1;
     } else if (command == "extract-rund" && argc >= 5) {
         extractRundSprites(argv[2], argv[3], argv[4]);
     } else if (command == "extract-rund-multi" && argc >= 6) {
@@ -5595,6 +6237,24 @@ int main(int argc, char* argv[]) {
         int width = std::stoi(argv[5]);
         int height = std::stoi(argv[6]);
         extractExplicitDims(argv[2], argv[3], offset, width, height, argv[7]);
+    } else if (command == "bench-rle" && argc >= 3) {
+        return benchRLE(argv[2]) ? 0 : 1;
+    } else if (command == "bench-lz" && argc >= 3) {
+        return benchLZ(argv[2]) ? 0 : 1;
+    } else if (command == "bench-smk" && (argc == 3 || argc == 5)) {
+        BaselineMode mode = BaselineMode::None;
+        if (argc == 5) {
+            std::string action = argv[3];
+            if (action == "check") {
+                mode = BaselineMode::Check;
+            } else if (action == "write") {
+                mode = BaselineMode::Write;
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        return benchSmacker(argv[2], mode, argc == 5 ? argv[4] : "") ? 0 : 1;
     } else {
         printUsage(argv[0]);
         return 1;